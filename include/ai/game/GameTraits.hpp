@@ -0,0 +1,152 @@
+#ifndef AI_GAME_GAMETRAITS_HPP
+#define AI_GAME_GAMETRAITS_HPP
+
+#include <limits>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+namespace ai {
+namespace game {
+
+namespace detail {
+
+template <typename, template <typename...> class Operation, typename... Args>
+struct detector: std::false_type {};
+
+template <template <typename...> class Operation, typename... Args>
+struct detector<std::void_t<Operation<Args...>>, Operation, Args...>: std::true_type {};
+
+template <typename State>
+using legal_actions_member = decltype(std::declval<const State&>().legal_actions());
+
+template <typename State>
+using ordered_actions_member = decltype(std::declval<const State&>().ordered_actions());
+
+template <typename State>
+using hvalue_member = decltype(std::declval<const State&>().hvalue());
+
+template <typename State>
+using is_maximizing_member = decltype(std::declval<const State&>().is_maximizing());
+
+template <typename State, typename Action>
+using unmove_action_member = decltype(std::declval<State&>().unmove(std::declval<Action>()));
+
+template <typename Action>
+using action_equality = decltype(std::declval<const Action&>() == std::declval<const Action&>());
+
+} // namespace detail
+
+template <template <typename...> class Operation, typename... Args>
+constexpr bool is_detected = detail::detector<void, Operation, Args...>::value;
+
+// the action type of State, State::ActionType or else what it lists
+template <typename State, typename = void>
+struct action_type_of {
+    using type = typename decltype(std::declval<const State&>().legal_actions())::value_type;
+};
+
+template <typename State>
+struct action_type_of<State, std::void_t<typename State::ActionType>> {
+    using type = typename State::ActionType;
+};
+
+// the value type of State, what hvalue() returns or else float
+template <typename State, typename = void>
+struct value_type_of {
+    using type = float;
+};
+
+template <typename State>
+struct value_type_of<State, std::void_t<detail::hvalue_member<State>>> {
+    using type = std::decay_t<detail::hvalue_member<State>>;
+};
+
+// the search view of a game state, resolved at compile time:
+//   the tic-tac-toe style with legalActions(), next_player(), is_terminal(Player&, float&)
+//   and unmove(action), or the gomoku style with legal_actions() or ordered_actions(),
+//   is_maximizing(), is_terminal(), hvalue() and unmove()
+// values are from the AI's point of view
+template <typename State>
+struct GameTraits {
+    using Action = typename action_type_of<State>::type;
+
+    static constexpr bool has_hvalue = is_detected<detail::hvalue_member, State>;
+
+    using Value = typename value_type_of<State>::type;
+
+    // bounds every value of the game
+    static constexpr Value infinity() {
+        if constexpr (std::numeric_limits<Value>::has_infinity)
+            return std::numeric_limits<Value>::infinity();
+        else
+            return std::numeric_limits<Value>::max();
+    }
+
+    static bool ai_to_move(const State& state) {
+        if constexpr (is_detected<detail::is_maximizing_member, State>)
+            return state.is_maximizing();
+        else
+            return state.next_player() == State::PLAYER_AI;
+    }
+
+    static bool is_terminal(const State& state, Value& utility) {
+        if constexpr (has_hvalue) {
+            if (!state.is_terminal())
+                return false;
+            utility = state.hvalue();
+            return true;
+        }
+        else {
+            typename State::PlayerType win_player;
+            float value;
+            if (!state.is_terminal(win_player, value))
+                return false;
+            utility = value;
+            return true;
+        }
+    }
+
+    // of a position at the depth limit, 0 for a game without a heuristic
+    static Value evaluate(const State& state) {
+        if constexpr (has_hvalue)
+            return state.hvalue();
+        else
+            return Value{};
+    }
+
+    // best first when the state orders them
+    static void actions(const State& state, std::vector<Action>& actions) {
+        if constexpr (is_detected<detail::ordered_actions_member, State>) {
+            auto listed = state.ordered_actions();
+            actions.assign(listed.begin(), listed.end());
+        }
+        else if constexpr (is_detected<detail::legal_actions_member, State>) {
+            auto listed = state.legal_actions();
+            actions.assign(listed.begin(), listed.end());
+        }
+        else {
+            auto listed = state.legalActions();
+            actions.assign(listed.begin(), listed.end());
+        }
+    }
+
+    static void unmove(State& state, const Action& action) {
+        if constexpr (is_detected<detail::unmove_action_member, State, Action>)
+            state.unmove(action);
+        else
+            state.unmove();
+    }
+
+    static bool same_action(const Action& a, const Action& b) {
+        if constexpr (is_detected<detail::action_equality, Action>)
+            return a == b;
+        else
+            return a.x() == b.x() && a.y() == b.y();
+    }
+};
+
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GAMETRAITS_HPP
@@ -2,74 +2,177 @@
 #define AI_GAME_MINIMAX_HPP
 
 #include <limits>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+#include "GameTraits.hpp"
+#include "TranspositionTable.hpp"
 
 namespace ai {
 namespace game {
 
+// entries of the transposition table of a hashable State
+#define MINIMAX_TABLE_SIZE (1 << 16)
+
+// negamax with alpha-beta pruning, scores are from the AI's point of view
+// outside and from the player to move's point of view inside the search,
+// positions are remembered in a transposition table when StateHash<State>
+// is specialized, the state is accessed through GameTraits<State>
 template <typename State>
 class Minimax {
+public:
+    using Traits = GameTraits<State>;
+    using ActionType = typename Traits::Action;
+    using Value = typename Traits::Value;
+
+    // the AI's point of view, called on the positions at the depth limit,
+    // Traits::evaluate() when empty
+    using Evaluation = std::function<Value(const State&)>;
+
+    static constexpr int unlimited = -1;
+
+    static constexpr bool hashed = has_state_hash<State>::value;
+
 private:
     State state_;
-    using ActionType = typename State::ActionType;
-    using PlayerType = typename State::PlayerType;
+    const int max_depth_;
+    Evaluation evaluate_;
 
-    struct MoveGaurd {
+    struct MoveGuard {
         State& state_;
         ActionType action_;
 
-        MoveGaurd(State& state, ActionType action)
+        MoveGuard(State& state, ActionType action)
             : state_{state}, action_{action} { state_.move(action_); }
 
-        ~MoveGaurd() { state_.unmove(action_); }
+        ~MoveGuard() { Traits::unmove(state_, action_); }
     };
-    
-    ActionType final_action_;
+
+    // the actions of each ply, kept between nodes so their capacity is reused,
+    // a deque so deeper plies don't move the shallower ones
+    std::deque<std::vector<ActionType>> plies_;
+
+    struct NoTable {};
+
+    std::conditional_t<hashed, TranspositionTable<ActionType, Value>, NoTable> table_;
+
+    ActionType final_action_{};
+    Value value_{};
+    unsigned long nodes_ = 0;
 
 private:
-    float minimax(int depth) {
-        auto player = state_.next_player();
-        PlayerType win_player;
-        float utility;
-
-        if (state_.is_terminal(win_player, utility))
-            return utility;
-
-        if (player == State::PLAYER_AI) {
-            float max = -std::numeric_limits<float>::infinity();
-            for (auto action: state_.legalActions()) {
-                MoveGaurd gaurd{state_, action};
-                float minimax_result = minimax(depth + 1);
-                if (max < minimax_result) {
-                    max = minimax_result;
-                    if (depth == 1) {
-                        final_action_ = action;
-                    }
-                }
+    std::vector<ActionType>& actions_of(int ply) {
+        if (int(plies_.size()) <= ply)
+            plies_.resize(ply + 1);
+        auto& actions = plies_[ply];
+        Traits::actions(state_, actions);
+        return actions;
+    }
+
+    Value sign(Value value) const {
+        return Traits::ai_to_move(state_) ? value : -value;
+    }
+
+    // plies left to search, a solved position is good for any depth
+    int depth_at(int ply) const {
+        return max_depth_ == unlimited ? std::numeric_limits<int>::max() : max_depth_ - ply;
+    }
+
+    Value negamax(int ply, Value alpha, Value beta) {
+        nodes_++;
+        Value utility;
+        if (Traits::is_terminal(state_, utility))
+            return sign(utility);
+
+        if (ply == max_depth_)
+            return sign(evaluate_ ? evaluate_(state_) : Traits::evaluate(state_));
+
+        const Value original_alpha = alpha;
+        std::uint64_t key = 0;
+        const TableEntry<ActionType, Value> *entry = nullptr;
+        if constexpr (hashed) {
+            key = StateHash<State>{}(state_);
+            entry = table_.probe(key);
+            // the root still searches to pick its move
+            if (entry && ply > 0 && entry->depth >= depth_at(ply)) {
+                if (entry->bound == TableBound::Exact)
+                    return entry->value;
+                if (entry->bound == TableBound::Lower)
+                    alpha = std::max(alpha, entry->value);
+                else
+                    beta = std::min(beta, entry->value);
+                if (alpha >= beta)
+                    return entry->value;
             }
-            return max;
         }
-        
-        if (player == State::PLAYER_PERSON) {
-            float min = std::numeric_limits<float>::infinity();
-            for (auto action: state_.legalActions()) {
-                MoveGaurd gaurd{state_, action};
-                float minimax_result = minimax(depth + 1);
-                if (min > minimax_result) {
-                    min = minimax_result;
-                }
+
+        auto& actions = actions_of(ply);
+        if (actions.empty())
+            return Value{};
+        if (entry) {
+            auto found = std::find_if(actions.begin(), actions.end(),
+                    [&](const ActionType& action) { return Traits::same_action(action, entry->best); });
+            if (found != actions.end())
+                std::rotate(actions.begin(), found, found + 1);
+        }
+        if (ply == 0)
+            final_action_ = actions.front();
+
+        ActionType best_action = actions.front();
+        Value best = -Traits::infinity();
+        for (auto action: actions) {
+            MoveGuard guard{state_, action};
+            Value score = -negamax(ply + 1, -beta, -alpha);
+            if (score > best) {
+                best = score;
+                best_action = action;
+                if (ply == 0)
+                    final_action_ = action;
             }
-            return min;
+            if (best > alpha)
+                alpha = best;
+            if (alpha >= beta)
+                break;
         }
+
+        if constexpr (hashed) {
+            auto bound = TableBound::Exact;
+            if (best <= original_alpha)
+                bound = TableBound::Upper;
+            else if (best >= beta)
+                bound = TableBound::Lower;
+            table_.store(key, best, depth_at(ply), bound, best_action);
+        }
+        return best;
+    }
+
+    static auto make_table() {
+        if constexpr (hashed)
+            return TranspositionTable<ActionType, Value>{MINIMAX_TABLE_SIZE};
+        else
+            return NoTable{};
     }
 
 public:
-    Minimax(const State& state): state_{state} {}
+    Minimax(const State& state, int max_depth = unlimited, Evaluation evaluate = {})
+        : state_{state}, max_depth_{max_depth}, evaluate_{std::move(evaluate)},
+          table_{make_table()} {}
 
     ActionType next_action() {
-        minimax(1);
+        const Value inf = Traits::infinity();
+        nodes_ = 0;
+        value_ = sign(negamax(0, -inf, inf));
         return final_action_;
     }
 
+    // of the position, after next_action()
+    Value value() const { return value_; }
+
+    // visited by the last next_action()
+    unsigned long nodes() const { return nodes_; }
+
 }; // class Minimax
 
 } // namespace game
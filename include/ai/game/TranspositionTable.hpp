@@ -0,0 +1,100 @@
+#ifndef AI_GAME_TRANSPOSITIONTABLE_HPP
+#define AI_GAME_TRANSPOSITIONTABLE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+namespace ai {
+namespace game {
+
+// specialize with
+//     std::uint64_t operator () (const State&) const
+// to let searches remember the positions of State, equal positions
+// must have equal hashes, the player to move included
+template <typename State, typename = void>
+struct StateHash {};
+
+// a State with a hash() member needs no specialization
+template <typename State>
+struct StateHash<State, std::void_t<decltype(std::declval<const State&>().hash())>> {
+    std::uint64_t operator () (const State& state) const { return state.hash(); }
+};
+
+template <typename State, typename = void>
+struct has_state_hash: std::false_type {};
+
+template <typename State>
+struct has_state_hash<State, std::void_t<decltype(
+        std::uint64_t{StateHash<State>{}(std::declval<const State&>())})>>
+    : std::true_type {};
+
+enum class TableBound: unsigned char {
+    Exact, Lower, Upper
+};
+
+template <typename Action, typename Value = float>
+struct TableEntry {
+    std::uint64_t key = 0;
+    Value value = Value{};
+    int depth = 0;
+    TableBound bound = TableBound::Exact;
+    bool used = false;
+    Action best{};
+};
+
+// direct-mapped, an entry of the same depth or a shallower one is replaced
+template <typename Action, typename Value = float>
+class TranspositionTable {
+public:
+    using Entry = TableEntry<Action, Value>;
+
+private:
+    std::vector<Entry> entries_;
+    std::uint64_t mask_;
+
+    static std::size_t floor_power_of_two(std::size_t size) {
+        std::size_t power = 1;
+        while (power * 2 <= size)
+            power *= 2;
+        return power;
+    }
+
+public:
+    // size is rounded down to a power of two
+    explicit TranspositionTable(std::size_t size)
+        : entries_(floor_power_of_two(size)), mask_{entries_.size() - 1} {}
+
+    // nullptr when the position is not stored
+    const Entry *probe(std::uint64_t key) const {
+        auto& entry = entries_[key & mask_];
+        return entry.used && entry.key == key ? &entry : nullptr;
+    }
+
+    void store(std::uint64_t key, Value value, int depth,
+            TableBound bound, Action best)
+    {
+        auto& entry = entries_[key & mask_];
+        if (entry.used && entry.key != key && entry.depth > depth)
+            return;
+        entry.key = key;
+        entry.value = value;
+        entry.depth = depth;
+        entry.bound = bound;
+        entry.used = true;
+        entry.best = best;
+    }
+
+    void clear() {
+        for (auto& entry: entries_)
+            entry = Entry{};
+    }
+
+    std::size_t size() const { return entries_.size(); }
+};
+
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_TRANSPOSITIONTABLE_HPP
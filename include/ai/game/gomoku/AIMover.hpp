@@ -2,34 +2,81 @@
 #define AI_GAME_GOMOKU_AIMOVER_HPP
 
 #include "State.hpp"
+#include "Mailbox.hpp"
+#include "SearchContext.hpp"
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <memory>
+#include <functional>
 
 namespace ai {
 namespace game {
 namespace gomoku {
 
+// searches a private copy of the state on one worker thread owned by the mover
 class AIMover {
 private:
-    State& state_;
+    struct Progress {
+        unsigned int job = 0;
+        SearchReport report;
+    };
+
+    const std::chrono::milliseconds time_limit_;
+
     std::thread thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::unique_ptr<State> pending_state_;
+    std::atomic_uint job_{0};
+    bool searching_ = false;
+    bool hurry_ = false;
+    bool quit_ = false;
+    std::atomic_bool cancelled_{false};
+
+    Mailbox<Progress> progress_;
+
+    // used by the worker only while searching
+    SearchContext context_;
+
     bool moved_ = false;
     Action recent_move_;
-    mutable std::mutex mutex_;
+    std::function<void()> on_moved_;
     std::atomic_bool thinking_{false};
 
+    void run();
+
 public:
-    AIMover(State& state);
+    AIMover(std::chrono::milliseconds time_limit = std::chrono::seconds(10));
+
+    // cancels the running search, if any
+    void next_move_in_background(const State& state);
+
+    // ends the running search, its best action so far becomes the move
+    void move_now();
 
-    void next_move_in_background();
+    // cancels the running search, no move is reported
+    void stop();
+
+    // stops and forgets what the searches of the last game learned
+    void new_game();
 
     bool moved();
 
+    // called on the worker thread, with the mover locked, whenever a move
+    // becomes available, so a waiting UI can wake up instead of polling moved()
+    void on_moved(std::function<void()> callback);
+
     Action recent_move() const;
 
     bool thinking() const;
 
+    // latest completed iteration of the current search, 
+    // to be called from a single thread
+    bool progress(SearchReport& report);
+
     ~AIMover();
 
 }; // class AIMover
@@ -0,0 +1,71 @@
+#ifndef AI_GAME_GOMOKU_ANALYSISCACHE_HPP
+#define AI_GAME_GOMOKU_ANALYSISCACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <shared_mutex>
+#include <unordered_map>
+#include "State.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+// slots probed for a key in the file
+#define ANALYSIS_CACHE_PROBES 4
+
+// the best move is in the canonical frame of the key
+struct AnalysisEntry {
+    Score score = 0;
+    unsigned char depth = 0;
+    Bound bound = Bound::Exact;
+    Action best = {0, 0};
+};
+
+// search results keyed by canonical_key_of(), kept in a memory-mapped file
+// that is opened on the first lookup, results of this process are merged 
+// into it by merge() or the destructor, lookups may run concurrently
+class AnalysisCache {
+private:
+    struct Header;
+    struct Slot;
+
+    const std::string path_;
+    const std::size_t capacity_;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::uint64_t, AnalysisEntry> pending_;
+
+    mutable bool loaded_ = false;
+    mutable const Slot *slots_ = nullptr;
+    mutable std::size_t slot_count_ = 0;
+    mutable std::size_t mapped_size_ = 0;
+
+    void load() const;
+
+    void unload();
+
+public:
+    // capacity only applies when the file gets created
+    explicit AnalysisCache(std::string path, std::size_t capacity = 1 << 20);
+
+    AnalysisCache(const AnalysisCache&) = delete;
+
+    AnalysisCache& operator = (const AnalysisCache&) = delete;
+
+    ~AnalysisCache();
+
+    bool lookup(std::uint64_t key, AnalysisEntry& entry) const;
+
+    // kept in memory until merged, a deeper result replaces a shallower one
+    void store(std::uint64_t key, const AnalysisEntry& entry);
+
+    // false when the file can't be written, the results are kept then
+    bool merge();
+};
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_ANALYSISCACHE_HPP
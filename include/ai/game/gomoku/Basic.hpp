@@ -2,6 +2,8 @@
 #define AI_GAME_GOMOKU_BASIC_HPP
 
 #include <vector>
+#include <cstdint>
+#include <cstddef>
 
 namespace ai {
 namespace game {
@@ -17,6 +19,35 @@ Cell inverse_of(Cell cell);
 
 using Line = std::vector<Cell>;
 
+// heuristic points times SCORE_SCALE, the scaling factors are multiples of 1/4
+typedef std::int32_t Score;
+
+#define SCORE_SCALE 4
+
+// five in a row, far above any sum of line scores
+static const Score win_score = 1 << 28;
+
+static const std::size_t max_move_count = 1 << 16;
+
+// the position where five was completed by the move_count-th move,
+// a win with fewer moves scores higher, a loss with more moves does
+inline Score win_at(std::size_t move_count) {
+    return win_score - Score(move_count < max_move_count ? move_count : max_move_count);
+}
+
+inline bool is_win(Score score) {
+    return score >= win_score - Score(max_move_count);
+}
+
+inline bool is_loss(Score score) {
+    return is_win(-score);
+}
+
+// how a stored search score relates to the true value
+enum class Bound: unsigned char {
+    Exact, Lower, Upper
+};
+
 } // namespace gomoku
 } // namespace game
 } // namespace ai
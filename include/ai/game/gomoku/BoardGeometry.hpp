@@ -0,0 +1,41 @@
+#ifndef AI_GAME_GOMOKU_BOARDGEOMETRY_HPP
+#define AI_GAME_GOMOKU_BOARDGEOMETRY_HPP
+
+#include "State.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+typedef Action Position;
+
+struct Coord {
+    int x, y;
+};
+
+// in [0, size) for negative values too
+int modulo(int value, int size);
+
+// where the cells of the unbounded board are on the screen, the cell (0, 0)
+// has its bottom left corner at the center when nothing is slid
+struct BoardGeometry {
+    int screen_width;
+    int screen_height;
+    int cell_size;
+    Coord slide = {0, 0};
+
+    // top left corner of the cell
+    Coord pos_to_coord(Position pos) const;
+
+    Position coord_to_pos(Coord coord) const;
+
+    // top left corner of a grid of whole cells covering the screen,
+    // within a cell above and left of the screen's corner
+    Coord grid_origin() const;
+};
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_BOARDGEOMETRY_HPP
@@ -0,0 +1,38 @@
+#ifndef AI_GAME_GOMOKU_CANONICALKEY_HPP
+#define AI_GAME_GOMOKU_CANONICALKEY_HPP
+
+#include <cstdint>
+#include "State.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+// one of the 8 symmetries of the board followed by a translation,
+// symmetry bit 0 swaps x and y, bit 1 negates x, bit 2 negates y
+struct Transform {
+    unsigned char symmetry = 0;
+    Action offset = {0, 0};
+
+    // board coordinates to canonical coordinates
+    Action apply(Action action) const;
+
+    // canonical coordinates back to board coordinates
+    Action inverse(Action action) const;
+};
+
+struct CanonicalKey {
+    std::uint64_t hash = 0;
+    Transform transform;
+};
+
+// equal for positions that differ by a translation, and by a rotation 
+// or a reflection too when symmetric is set, coordinates are taken 
+// relative to the bounding box of the stones
+CanonicalKey canonical_key_of(const State& state, bool symmetric = true);
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_CANONICALKEY_HPP
@@ -0,0 +1,44 @@
+#ifndef AI_GAME_GOMOKU_EVALCACHE_HPP
+#define AI_GAME_GOMOKU_EVALCACHE_HPP
+
+#include <cstdint>
+#include "Basic.hpp"
+#include "LineMask.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+// entries of the per-thread cache, 24 bytes each
+#define EVAL_CACHE_SIZE 4096
+
+struct EvalCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+
+    double hit_rate() const {
+        auto total = hits + misses;
+        return total == 0 ? 0.0 : double(hits) / total;
+    }
+};
+
+// score_of_masks() memoized in a direct-mapped cache of the calling thread,
+// masks are shifted down first so the same pattern hits anywhere on a line
+Score cached_score_of_masks(std::uint64_t player, std::uint64_t opponent);
+
+// scores_of_masks() from the same cache, a single probe for both players
+LineScores cached_scores_of_masks(std::uint64_t ai, std::uint64_t human);
+
+// statistics of the calling thread
+EvalCacheStats eval_cache_stats();
+
+void reset_eval_cache_stats();
+
+// drops the entries and the statistics of the calling thread
+void clear_eval_cache();
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_EVALCACHE_HPP
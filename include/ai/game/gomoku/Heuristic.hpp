@@ -2,24 +2,32 @@
 #define AI_GAME_GOMOKU_HEURISTIC_HPP
 
 #include <bitset>
+#include <numeric>
+#include <iterator>
+#include <algorithm>
 #include "Basic.hpp"
+#include "InfiniteMatrix.hpp"
+#include "LineMask.hpp"
+#include "EvalCache.hpp"
 
 namespace ai {
 namespace game {
 namespace gomoku {
 
-class LineView {
+// a range of cells of a Line or a StridedView
+template <typename Iterator>
+class BasicLineView {
 private:
-    Line::const_iterator begin_, end_;
+    Iterator begin_, end_;
 
 public:
-    using iterator = Line::const_iterator;
+    using iterator = Iterator;
 
 public:
-    LineView(const Line& line, int begin, int end)
+    BasicLineView(const Line& line, int begin, int end)
         : begin_{line.cbegin() + begin}, end_{line.cbegin() + end} {}
 
-    LineView(Line::const_iterator begin, Line::const_iterator end)
+    BasicLineView(Iterator begin, Iterator end)
         : begin_{begin}, end_{end} {}
 
     auto begin() const { return begin_; }
@@ -27,6 +35,8 @@ public:
     auto end() const { return end_; }
 };
 
+using LineView = BasicLineView<Line::const_iterator>;
+
 #define MAX_BIT_COUNT 5
 
 struct SegmentInfo {
@@ -41,16 +51,152 @@ struct SegmentInfo {
     size_t cell_count = 0;
 };
 
-std::bitset<MAX_BIT_COUNT> get_segment_bitset(
-        LineView line_view, Cell compared_value, size_t& cell_count);
-
 typedef std::vector<SegmentInfo> SegmentInfoList;
 
-void get_segment_infos(const Line& line, Cell compared_value, SegmentInfoList& result);
-
-float score_of(SegmentInfo segment);
-
-float score_of_line(const Line& line, Cell player);
+// win_score for a five
+Score score_of(SegmentInfo segment);
+
+// the lines below are a Line or a StridedView<Cell>, the segment walk
+// only needs random access iterators
+
+template <typename Iterator>
+BasicLineView<Iterator> maximum_view(BasicLineView<Iterator> segment, size_t size) {
+    int max = 0;
+    Iterator new_begin, new_end;
+    for (auto it = segment.begin(); it != std::prev(segment.end(), size); ++it) {
+        auto sum = std::accumulate(it, std::next(it, size), 0,
+            [](int sum, Cell cell) { 
+                return cell == Cell::NONE ? sum : sum + 1; 
+        });
+
+        if (sum > max) {
+            max = sum;
+            new_begin = it;
+            new_end = std::next(it, size);
+        }
+    }
+    return {new_begin, new_end};
+}
+
+template <typename Iterator>
+std::bitset<MAX_BIT_COUNT> get_segment_bitset(
+        BasicLineView<Iterator> segment, Cell compared_value, size_t& cell_count)
+{
+    std::bitset<MAX_BIT_COUNT> cells = 0;
+    cell_count = segment.end() - segment.begin();
+    if (cell_count > MAX_BIT_COUNT) {
+        segment = maximum_view(segment, MAX_BIT_COUNT);
+    }
+    for (auto it = segment.begin(); it != segment.end(); ++it) 
+        if (*it == compared_value)
+            cells[std::distance(segment.begin(), it)] = 1;
+    return cells;
+}
+
+template <typename Iterator>
+SegmentInfo::Distance left_distance_of(Iterator it, Iterator begin) {
+    std::reverse_iterator<Iterator> rit{it};
+    std::reverse_iterator<Iterator> rend{begin};
+
+    auto find_rit = std::find_if(rit, rend, [](Cell cell) { return cell != Cell::NONE; });
+
+    if (find_rit == rend)
+        return SegmentInfo::Infinity;
+    if (std::distance(rit, find_rit) == 0)
+        return SegmentInfo::Zero;
+    if (std::distance(rit, find_rit) == 1)
+        return SegmentInfo::One;
+    return SegmentInfo::Infinity;
+}
+
+template <typename Iterator>
+SegmentInfo::Distance right_distance_of(Iterator it, Iterator end) {
+    auto find_it = std::find_if(it, end, [](Cell cell) { return cell != Cell::NONE; });
+
+    if (find_it == end)
+        return SegmentInfo::Infinity;
+    if (std::distance(it, find_it) == 0)
+        return SegmentInfo::Zero;
+    if (std::distance(it, find_it) == 1)
+        return SegmentInfo::One;
+    return SegmentInfo::Infinity;
+}
+
+template <typename Iterator>
+Iterator reverse_search(Iterator it, Iterator begin, Cell value) {
+    std::reverse_iterator<Iterator> rit{it};
+    std::reverse_iterator<Iterator> rend{begin};
+    return std::find_if(rit, rend, [value](Cell cell) { return cell == value; }).base();
+}
+
+template <typename Lines>
+void get_segment_infos(const Lines& line, Cell compared_value, SegmentInfoList& result) {
+    using Iterator = decltype(line.begin());
+    result.clear();
+
+    auto it = line.begin();
+    while (true) {
+        it = std::find_if(it, line.end(), 
+                [compared_value](Cell cell) { return cell == compared_value; });
+        auto segment_begin = it;
+
+        if (it == line.end())
+            break;
+
+        it = std::find_if(it, line.end(), 
+                [compared_value](Cell cell) { 
+                    return cell == inverse_of(compared_value); 
+        });
+        auto segment_end = reverse_search(it, segment_begin, compared_value);
+
+        SegmentInfo info;
+        info.cells = get_segment_bitset(
+                BasicLineView<Iterator>{segment_begin, segment_end}, 
+                compared_value, info.cell_count);
+        info.distances[0] = left_distance_of(segment_begin, line.begin());
+        info.distances[1] = right_distance_of(segment_end, line.end());
+        result.push_back(info);
+    }
+}
+
+// reference implementation, walks the segments cell by cell
+template <typename Lines>
+Score segment_score_of_line(const Lines& line, Cell player) {
+    Score result = 0;
+    static thread_local SegmentInfoList infos(100);
+    infos.clear();
+    get_segment_infos(line, player, infos);
+    for (auto info: infos) {
+        auto score = score_of(info);
+        if (score == win_score)
+            return win_score;
+        result += score;
+    }
+    return result;
+}
+
+// win_score when the line has a five
+template <typename Lines>
+Score score_of_line(const Lines& line, Cell player) {
+    if (line.size() > MAX_LINE_MASK_SIZE)
+        return segment_score_of_line(line, player);
+
+    auto masks = line_masks_of(line);
+    if (player == Cell::AI)
+        return cached_score_of_masks(masks.ai, masks.human);
+    return cached_score_of_masks(masks.human, masks.ai);
+}
+
+// score_of_line() of both players from a single scan of the line
+template <typename Lines>
+LineScores scores_of_line(const Lines& line) {
+    if (line.size() > MAX_LINE_MASK_SIZE)
+        return {segment_score_of_line(line, Cell::AI),
+                segment_score_of_line(line, Cell::HUMAN)};
+
+    auto masks = line_masks_of(line);
+    return cached_scores_of_masks(masks.ai, masks.human);
+}
 
 } // namespace gomoku
 } // namespace game
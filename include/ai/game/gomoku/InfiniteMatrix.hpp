@@ -2,6 +2,9 @@
 #define AI_GAME_GOMOKU_INFINITEMATRIX_HPP
 
 #include <vector>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
 
 namespace ai {
 namespace game {
@@ -23,21 +26,92 @@ template<typename Type>
 std::vector<Type> frame_changed_copy(
         const std::vector<Type>& matrix, Frame old_frame, Frame new_frame)
 {
-    std::vector<Type> result;
-    result.resize(new_frame.w * new_frame.h);
-    for (int y = new_frame.y; y < new_frame.y + new_frame.h; y++) {
-        for (int x = new_frame.x; x < new_frame.x + new_frame.w; x++) {
-            if (fall_inside(x, y, old_frame)) 
-                result[index_of(x, y, new_frame)] = matrix[index_of(x, y, old_frame)];
-            else
-                result[index_of(x, y, new_frame)] = Type{};
-        }
+    std::vector<Type> result(new_frame.w * new_frame.h, Type{});
+    int left = std::max(old_frame.x, new_frame.x);
+    int right = std::min(old_frame.x + old_frame.w, new_frame.x + new_frame.w);
+    int top = std::max(old_frame.y, new_frame.y);
+    int bottom = std::min(old_frame.y + old_frame.h, new_frame.y + new_frame.h);
+    if (left >= right)
+        return result;
+    // the overlapping part of each row is contiguous in both frames
+    for (int y = top; y < bottom; y++) {
+        auto row = matrix.begin() + index_of(left, y, old_frame);
+        std::copy(row, row + (right - left),
+                result.begin() + index_of(left, y, new_frame));
     }
     return result;
 }
 
 Frame new_inused_frame(Frame old_inused, int x, int y);
 
+// [begin, end) of the t for which (x + t * dx, y + t * dy) falls inside frame,
+// dx and dy are -1, 0 or 1
+void clip_line(int x, int y, int dx, int dy, Frame frame, int& begin, int& end);
+
+// size cells of a matrix, stride elements apart, without copying them
+template <typename Type>
+class StridedView {
+public:
+    class iterator {
+    private:
+        const Type *pointer_ = nullptr;
+        std::ptrdiff_t stride_ = 1;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type *;
+        using reference = const Type&;
+
+        iterator() = default;
+        iterator(const Type *pointer, std::ptrdiff_t stride)
+            : pointer_{pointer}, stride_{stride} {}
+
+        reference operator * () const { return *pointer_; }
+        reference operator [] (difference_type n) const { return pointer_[n * stride_]; }
+
+        iterator& operator ++ () { pointer_ += stride_; return *this; }
+        iterator& operator -- () { pointer_ -= stride_; return *this; }
+        iterator operator ++ (int) { auto old = *this; ++*this; return old; }
+        iterator operator -- (int) { auto old = *this; --*this; return old; }
+        iterator& operator += (difference_type n) { pointer_ += n * stride_; return *this; }
+        iterator& operator -= (difference_type n) { pointer_ -= n * stride_; return *this; }
+        iterator operator + (difference_type n) const { return {pointer_ + n * stride_, stride_}; }
+        iterator operator - (difference_type n) const { return {pointer_ - n * stride_, stride_}; }
+        difference_type operator - (iterator other) const { return (pointer_ - other.pointer_) / stride_; }
+
+        bool operator == (iterator other) const { return pointer_ == other.pointer_; }
+        bool operator != (iterator other) const { return pointer_ != other.pointer_; }
+        bool operator < (iterator other) const { return *this - other < 0; }
+        bool operator > (iterator other) const { return other < *this; }
+        bool operator <= (iterator other) const { return !(other < *this); }
+        bool operator >= (iterator other) const { return !(*this < other); }
+    };
+
+    using const_iterator = iterator;
+
+private:
+    const Type *data_ = nullptr;
+    std::ptrdiff_t stride_ = 1;
+    int size_ = 0;
+
+public:
+    StridedView() = default;
+    StridedView(const Type *data, std::ptrdiff_t stride, int size)
+        : data_{data}, stride_{stride}, size_{size} {}
+
+    const Type *data() const { return data_; }
+    std::ptrdiff_t stride() const { return stride_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const Type& operator [] (int i) const { return data_[i * stride_]; }
+
+    iterator begin() const { return {data_, stride_}; }
+    iterator end() const { return {data_ + size_ * stride_, stride_}; }
+};
+
 void aligned_extend_range(int& begin, int& size, int new_value, bool& changed);
 
 template <typename Type>
@@ -47,6 +121,10 @@ private:
     Frame inused_;
     Frame frame_;
 
+    explicit InfiniteMatrix(Frame frame): frame_{frame} {
+        data_.resize(frame.w * frame.h);
+    }
+
 public:
     InfiniteMatrix(): InfiniteMatrix(INIT_MATRIX_SIZE) {}
 
@@ -62,6 +140,13 @@ public:
         return data_[index_of(x, y, frame_)];
     }
 
+    // Type{} outside of the allocated frame
+    Type get(int x, int y) const {
+        if (!fall_inside(x, y, frame_))
+            return Type{};
+        return data_[index_of(x, y, frame_)];
+    }
+
     Type& operator () (int x, int y) {
         bool changed = false;
         Frame new_frame = frame_;
@@ -79,6 +164,95 @@ public:
         return data_[index_of(x, y, frame_)];
     }
 
+    // grows the frames once to cover the whole region
+    void ensure(Frame region) {
+        if (region.w <= 0 || region.h <= 0)
+            return;
+        int right = region.x + region.w - 1;
+        int bottom = region.y + region.h - 1;
+        inused_ = new_inused_frame(inused_, region.x, region.y);
+        inused_ = new_inused_frame(inused_, right, bottom);
+
+        bool changed = false;
+        Frame new_frame = frame_;
+        aligned_extend_range(new_frame.x, new_frame.w, region.x, changed);
+        aligned_extend_range(new_frame.x, new_frame.w, right, changed);
+        aligned_extend_range(new_frame.y, new_frame.h, region.y, changed);
+        aligned_extend_range(new_frame.y, new_frame.h, bottom, changed);
+
+        if (changed) {
+            data_ = frame_changed_copy(data_, frame_, new_frame);
+            frame_ = new_frame;
+        }
+    }
+
+    // calls function(Type&) on every cell of the region, one row span at a time
+    template <typename Function>
+    void transform(Frame region, Function function) {
+        ensure(region);
+        for (int y = region.y; y < region.y + region.h; y++) {
+            auto row = data_.begin() + index_of(region.x, y, frame_);
+            std::for_each(row, row + region.w, function);
+        }
+    }
+
+    void add(Frame region, Type value) {
+        transform(region, [value](Type& cell) { cell += value; });
+    }
+
+    void fill(Frame region, Type value) {
+        transform(region, [value](Type& cell) { cell = value; });
+    }
+
+    // calls function(x, y, value) on the allocated cells of the region,
+    // the others are Type{}
+    template <typename Function>
+    void for_each(Frame region, Function function) const {
+        int left = std::max(region.x, frame_.x);
+        int right = std::min(region.x + region.w, frame_.x + frame_.w);
+        int top = std::max(region.y, frame_.y);
+        int bottom = std::min(region.y + region.h, frame_.y + frame_.h);
+        if (left >= right || top >= bottom)
+            return;
+        for (int y = top; y < bottom; y++) {
+            auto row = data_.begin() + index_of(left, y, frame_);
+            for (int x = left; x < right; x++)
+                function(x, y, row[x - left]);
+        }
+    }
+
+    // the used cells on the line through (x, y) in direction (dx, dy),
+    // in order of increasing x (increasing y for a column), invalidated
+    // when the frame grows
+    StridedView<Type> line(int x, int y, int dx, int dy) const {
+        int begin, end;
+        clip_line(x, y, dx, dy, inused_, begin, end);
+        if (begin == end)
+            return {};
+        auto first = data_.data() + index_of(x + begin * dx, y + begin * dy, frame_);
+        return {first, dx + std::ptrdiff_t(dy) * frame_.w, end - begin};
+    }
+
+    // a copy whose frame only covers the used cells and a margin around them
+    InfiniteMatrix compact_copy(int margin) const {
+        Frame frame = inused_;
+        if (frame.w == 0 || frame.h == 0)
+            frame = {0, 0, 1, 1};
+        frame.x -= margin;
+        frame.y -= margin;
+        frame.w += margin * 2;
+        frame.h += margin * 2;
+
+        InfiniteMatrix result{frame};
+        result.inused_ = inused_;
+        for (int y = inused_.y; y < inused_.y + inused_.h; y++) {
+            auto source = data_.begin() + index_of(inused_.x, y, frame_);
+            std::copy(source, source + inused_.w, 
+                    result.data_.begin() + index_of(inused_.x, y, frame));
+        }
+        return result;
+    }
+
     auto frame() const { return frame_; }
 
     auto inused() const { return inused_; }
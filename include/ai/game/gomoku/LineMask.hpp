@@ -0,0 +1,56 @@
+#ifndef AI_GAME_GOMOKU_LINEMASK_HPP
+#define AI_GAME_GOMOKU_LINEMASK_HPP
+
+#include <cstdint>
+#include "Basic.hpp"
+#include "InfiniteMatrix.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+#define MAX_LINE_MASK_SIZE 64
+
+// bit i is set when the i-th cell of the line belongs to the player
+struct LineMasks {
+    std::uint64_t ai = 0;
+    std::uint64_t human = 0;
+};
+
+// size must not exceed MAX_LINE_MASK_SIZE
+LineMasks line_masks_of(const Cell *cells, int size);
+
+LineMasks line_masks_scalar(const Cell *cells, int size);
+
+// cells[0], cells[stride], ..., only stride 1 is vectorized
+LineMasks line_masks_of(const Cell *cells, int size, std::ptrdiff_t stride);
+
+inline LineMasks line_masks_of(const Line& line) {
+    return line_masks_of(line.data(), line.size());
+}
+
+inline LineMasks line_masks_of(const StridedView<Cell>& line) {
+    return line_masks_of(line.data(), line.size(), line.stride());
+}
+
+// win_score when the player has a five
+Score score_of_masks(std::uint64_t player, std::uint64_t opponent);
+
+struct LineScores {
+    Score ai = 0;
+    Score human = 0;
+};
+
+// score_of_masks() of both players in one pass, each segment ends where
+// a segment of the other player begins
+LineScores scores_of_masks(std::uint64_t ai, std::uint64_t human);
+
+// whether the player's run through index has five stones or more,
+// an exact five blocked by the opponent at both ends doesn't count
+bool is_five_through(std::uint64_t player, std::uint64_t opponent, int index);
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_LINEMASK_HPP
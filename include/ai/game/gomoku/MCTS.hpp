@@ -0,0 +1,35 @@
+#ifndef AI_GAME_GOMOKU_MCTS_HPP
+#define AI_GAME_GOMOKU_MCTS_HPP
+
+#include "State.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+struct MCTSOptions {
+    // 0 uses every hardware thread
+    unsigned int threads = 0;
+    // stops the search without a deadline or a stop flag
+    unsigned int max_playouts = 20000;
+    // nodes of the arena, the tree stops growing when it is full
+    unsigned int max_nodes = 1 << 18;
+    // children of a node, taken from ordered_actions()
+    unsigned int branching = 12;
+    // moves of a playout before the position is judged by hvalue()
+    unsigned int playout_depth = 12;
+    // a playout picks at random among this many best ordered actions
+    unsigned int playout_width = 3;
+    float exploration = 0.7f;
+};
+
+// UCT search sharing one tree across threads with virtual loss, 
+// plays for the current player of the state, which is left unchanged
+Action MCTS_next_move(State& state, const SearchControl& control = {}, 
+        const MCTSOptions& options = {});
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_MCTS_HPP
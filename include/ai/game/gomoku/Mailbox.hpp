@@ -0,0 +1,52 @@
+#ifndef AI_GAME_GOMOKU_MAILBOX_HPP
+#define AI_GAME_GOMOKU_MAILBOX_HPP
+
+#include <atomic>
+#include <type_traits>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+// single-slot, lock-free channel from one writer thread to one reader thread,
+// the reader always sees the most recently published value
+template <typename Type>
+class Mailbox {
+private:
+    static_assert(std::is_trivially_copyable<Type>::value,
+            "Mailbox values are copied between threads");
+
+    static constexpr unsigned char fresh = 0x4;
+    static constexpr unsigned char index_mask = 0x3;
+
+    Type buffers_[3] = {};
+    std::atomic<unsigned char> middle_{1};
+    unsigned char back_ = 0;
+    unsigned char front_ = 2;
+    bool received_ = false;
+
+public:
+    // writer thread only
+    void publish(const Type& value) {
+        buffers_[back_] = value;
+        back_ = middle_.exchange(back_ | fresh, std::memory_order_acq_rel) & index_mask;
+    }
+
+    // reader thread only, false until the first value is published
+    bool read(Type& value) {
+        if (middle_.load(std::memory_order_relaxed) & fresh) {
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+            received_ = true;
+        }
+        if (!received_)
+            return false;
+        value = buffers_[front_];
+        return true;
+    }
+};
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_MAILBOX_HPP
@@ -2,30 +2,41 @@
 #define AI_GAME_GOMOKU_MATRIXRENDERER_HPP
 
 #include <SDL2/SDL.h>
-#include <vector>
+#include <unordered_map>
+#include <cstdint>
 #include "State.hpp"
+#include "BoardGeometry.hpp"
 
 namespace ai {
 namespace game {
 namespace gomoku {
 
-typedef Action Position;
-
-struct Coord {
-    int x, y;
-};
-
+// the board is unbounded, only the cells that aren't N are stored
 class MatrixRenderer {
 private:
-    std::vector<SDL_Texture *> matrix_;
+    struct Stone {
+        Position pos;
+        SDL_Texture *texture;
+    };
+
+    std::unordered_map<std::uint64_t, Stone> stones_;
     SDL_Renderer *renderer_ = nullptr;
     Coord slide_vector_ = {0, 0};
     Coord old_slide_vector_ = {0, 0};
 
-    Coord pos_to_coord(Position pos) const;
+    // N cells covering the screen with a cell of margin, slid by less than
+    // a cell, null when the renderer has no target textures
+    SDL_Texture *grid_ = nullptr;
+
+    BoardGeometry geometry() const {
+        return {screen_width, screen_height, cell_size, slide_vector_};
+    }
+
+    Coord pos_to_coord(Position pos) const { return geometry().pos_to_coord(pos); }
+
+    void render_grid() const;
 
 public:
-    const int matrix_size;
     const int screen_width;
     const int screen_height;
     const int cell_size = 30;
@@ -34,31 +45,31 @@ public:
 public:
     MatrixRenderer(
             SDL_Renderer *renderer,
-            int matrix_size, 
             int screen_width, 
             int screen_height);
 
-    MatrixRenderer(
-            SDL_Renderer *renderer,
-            int screen_width, 
-            int screen_height)
-        : MatrixRenderer(renderer, 100, screen_width, screen_height) {}
-
     ~MatrixRenderer();
 
+    // N for an empty cell
     SDL_Texture *operator () (Position pos) const;
 
-    SDL_Texture *& operator () (Position pos);
+    void set(Position pos, SDL_Texture *texture);
 
     void reset();
 
+    // draws the cached grid again, after its content has been lost
+    void redraw();
+
     void begin_slide();
 
     void slide(Coord dv);
 
     void render() const;
 
-    Position coord_to_pos(Coord coord) const;
+    // a frame around the cell
+    void highlight(Position pos, SDL_Color color) const;
+
+    Position coord_to_pos(Coord coord) const { return geometry().coord_to_pos(coord); }
 
 }; // class MatrixRenderer
 
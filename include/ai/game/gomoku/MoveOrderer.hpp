@@ -12,7 +12,7 @@ typedef std::vector<Action> Actions;
 
 struct ActionHvalue {
     Action action;
-    float hvalue;
+    Score hvalue;
 };
 
 struct ActionsHash {
@@ -25,7 +25,7 @@ private:
     Actions move_stack_;
 
 public:
-    void add_action(Action action, float hvalue);
+    void add_action(Action action, Score hvalue);
 
     bool actions_stored() const;
 
@@ -6,29 +6,45 @@
 #include "MatrixRenderer.hpp"
 #include "AIMover.hpp"
 #include <memory>
-#include <string>
 #include <optional>
 
 namespace ai {
 namespace game {
 namespace gomoku {
 
-class TextRenderer {
+// the shortest time between two frames, while dragging for instance
+#define FRAME_INTERVAL_MS 16
+
+// how long the loop sleeps when nothing happens, in case a wake-up gets lost
+#define IDLE_WAIT_MS 500
+
+// the search overlay is refreshed at most this often
+#define OVERLAY_INTERVAL_MS 100
+
+// the printable ASCII characters of a font drawn once into a single texture,
+// a line of text is then a run of copies from it, which SDL batches
+class GlyphAtlas {
 private:
-    SDL_Texture *texture_;
+    struct Glyph {
+        SDL_Rect source = {0, 0, 0, 0};
+        int advance = 0;
+    };
+
     SDL_Renderer *renderer_;
-    SDL_Rect rect_;
+    SDL_Texture *texture_ = nullptr;
+    Glyph glyphs_[128];
+    int height_ = 0;
 
 public:
-    TextRenderer(TTF_Font *font, 
-            SDL_Renderer *renderer,
-            const std::string& string, 
-            SDL_Color color,
-            int x, int y);
+    GlyphAtlas(TTF_Font *font, SDL_Renderer *renderer, SDL_Color color);
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator = (const GlyphAtlas&) = delete;
 
-    void render();
+    // returns the height of the line
+    int render(const char *text, int x, int y) const;
 
-    ~TextRenderer();
+    ~GlyphAtlas();
 };
 
 class Game {
@@ -50,10 +66,7 @@ private:
 
     std::unique_ptr<MatrixRenderer> matrix_renderer_;
     std::unique_ptr<AIMover> ai_mover_;
-    std::unique_ptr<TextRenderer> ai_thinking_;
-    std::unique_ptr<TextRenderer> ai_won_;
-    std::unique_ptr<TextRenderer> you_won_;
-    std::unique_ptr<TextRenderer> guide_;
+    std::unique_ptr<GlyphAtlas> text_;
 
     Cell start_player_ = Cell::HUMAN;
     std::unique_ptr<Game> game_;
@@ -62,6 +75,17 @@ private:
     bool dragging_ = false;
     Coord begin_drag_ = {0, 0};
 
+    // posted by the AI worker when its move is ready
+    Uint32 ai_moved_event_;
+    bool dirty_ = true;
+    Uint32 last_frame_ = 0;
+
+    // latest progress of the running search
+    bool has_report_ = false;
+    SearchReport report_;
+    Uint32 thinking_since_ = 0;
+    Uint32 last_overlay_ = 0;
+
     TTF_Font *Sans_;
 
 private:
@@ -81,6 +105,17 @@ private:
 
     void display_texts();
 
+    void handle_ai_move();
+
+    void update_overlay();
+
+    void display_overlay();
+
+    // false on quit
+    bool handle_event(const SDL_Event& event);
+
+    void render_frame();
+
 public:
     SDLWrapper();
 
@@ -0,0 +1,74 @@
+#ifndef AI_GAME_GOMOKU_SEARCHCONTEXT_HPP
+#define AI_GAME_GOMOKU_SEARCHCONTEXT_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "State.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+struct TranspositionEntry {
+    std::uint64_t key = 0;
+    Score score = 0;
+    unsigned char depth = 0;
+    Bound bound = Bound::Exact;
+    unsigned char generation = 0;
+    Action best = {0, 0};
+};
+
+// what the searches of one game keep between turns: a transposition table 
+// keyed by State::hash(), history counts of cutoff moves and the last 
+// principal variation, not thread safe
+class SearchContext {
+private:
+    std::vector<TranspositionEntry> table_;
+    std::unordered_map<std::uint64_t, unsigned int> history_;
+    std::vector<Action> principal_variation_;
+    // State::hash() of the position before each move of the variation
+    std::vector<std::uint64_t> principal_keys_;
+    unsigned char generation_ = 0;
+
+public:
+    // table_size is rounded down to a power of two
+    explicit SearchContext(std::size_t table_size = 1 << 18);
+
+    // nullptr when the position is not stored
+    const TranspositionEntry *probe(std::uint64_t key) const;
+
+    // an entry of an older search or a shallower one gets replaced
+    void store(std::uint64_t key, Score score, unsigned int depth, 
+            Bound bound, Action best);
+
+    void reward(Action action, unsigned int depth);
+
+    unsigned int history(Action action) const;
+
+    // ages the stored entries
+    void next_search();
+
+    void set_principal_variation(std::vector<Action> actions, 
+            std::vector<std::uint64_t> keys);
+
+    // from the position of the last search
+    const std::vector<Action>& principal_variation() const { 
+        return principal_variation_; 
+    }
+
+    // the opponent's answer the last search expected, false if there is none
+    bool expected_reply(Action& action) const;
+
+    // the move of the last principal variation from the position of the key,
+    // false if the variation doesn't pass through it
+    bool principal_move(std::uint64_t key, Action& action) const;
+
+    void clear();
+};
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_GOMOKU_SEARCHCONTEXT_HPP
@@ -3,11 +3,16 @@
 
 #include <vector>
 #include <memory>
-#include <stack>
+#include <string>
 #include <array>
 #include <unordered_map>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include "Basic.hpp"
 #include "InfiniteMatrix.hpp"
+#include "EvalCache.hpp"
 
 namespace ai {
 namespace game {
@@ -21,40 +26,141 @@ bool operator == (Action action1, Action action2);
 
 static const int allow_distance = 2;
 static const unsigned int alphabeta_depth = 2;
+static const int threat_radius = 5;
+
+// pattern gain of playing a cell, per line direction and per player
+struct Threat {
+    Score gains[4][2] = {};
+    // whether the stone completes five along the direction
+    bool fives[4][2] = {};
+    unsigned char dirty = 0xF;
+};
+
+// a position as the start player and the moves played from the empty board
+struct Snapshot {
+    Cell start_player = Cell::HUMAN;
+    std::vector<Action> moves;
+};
+
+// compact binary form, zigzag varints of the move coordinates
+std::string serialize(const Snapshot& snapshot);
+
+// throws std::invalid_argument on malformed data
+Snapshot deserialize(const std::string& data);
+
+class SearchContext;
 
 class State {
 private:
     InfiniteMatrix<Cell> cells_;
     InfiniteMatrix<unsigned char> allow_cells_;
     Cell current_player_;
-    std::stack<Action> move_stack_;
-    std::stack<bool> terminated_stack_;
-    std::stack<float> hvalue_stack_;
+    std::vector<Action> move_stack_;
+    std::vector<bool> terminated_stack_;
+    std::vector<Score> hvalue_stack_;
+    std::uint64_t hash_ = 0;
+
+    mutable InfiniteMatrix<Threat> threats_;
+    mutable std::vector<std::pair<Action, Threat>> threat_log_;
+    std::vector<size_t> threat_marks_;
+
+    void set_threat(Action action, Threat threat) const;
+
+    void mark_threats(Action action);
+
+    Threat refreshed_threat(Action action) const;
+
+    State(const State& other, int margin);
 
 public:
     State(Cell start_player = Cell::HUMAN);
 
+    // replays the moves of the snapshot, throws std::invalid_argument
+    // when one of them is not legal or follows a five
+    explicit State(const Snapshot& snapshot);
+
+    Snapshot snapshot() const;
+
+    // copies only the used part of the board
+    State clone() const;
+
+    const std::vector<Action>& moves() const { return move_stack_; }
+
     std::vector<Action> legal_actions() const;
 
+    // an empty cell near a stone, whether or not the game is over
+    bool is_legal(Action action) const;
+
     Cell operator() (int x, int y) const;
 
     void move(Action action);
 
     void unmove();
 
-    float hvalue() const { return hvalue_stack_.top(); }
+    // win_at() or its negation once a player has five
+    Score hvalue() const { return hvalue_stack_.back(); }
 
-    bool is_terminal() const { return terminated_stack_.top(); }
+    // set by move() when the stone completes five, without evaluating lines
+    bool is_terminal() const { return terminated_stack_.back(); }
 
     bool is_maximizing() const { return current_player() == Cell::AI; }
 
     Cell current_player() const { return current_player_; }
 
+    // whether the player's stone at the action would complete five
+    bool wins(Action action, Cell player) const;
+
+    // increase of the player's own line scores when playing the action,
+    // looking threat_radius cells along each line
+    Score gain(Action action, Cell player) const;
+
+    // legal actions by gain of the current player plus gain of the opponent
+    // the context's history breaks ties between equal gains
+    std::vector<Action> ordered_actions(size_t max_count = SIZE_MAX, 
+            const SearchContext *context = nullptr) const;
+
+    // key of the stones and the player to move, updated by move() and unmove()
+    std::uint64_t hash() const;
+
+    // winning actions of the current player, or else the ones blocking 
+    // the opponent's wins, as marked in the threat map
+    std::vector<Action> forcing_actions() const;
+
 }; // class State
 
-float alphabeta(State& state, unsigned int depth, float alpha, float beta);
+// result of one completed iteration of AI_next_move
+struct SearchReport {
+    Action best = {0, 0};
+    Score score = 0;
+    unsigned int depth = 0;
+    EvalCacheStats cache;
+    // since the search began
+    std::uint64_t nodes = 0;
+    std::chrono::milliseconds elapsed{0};
+};
+
+class AnalysisCache;
+
+// checked at every node, a stopped search returns as soon as possible
+struct SearchControl {
+    const std::atomic_bool *stop = nullptr;
+    std::chrono::steady_clock::time_point deadline = 
+        std::chrono::steady_clock::time_point::max();
+    std::function<void(const SearchReport&)> report;
+    // completed searches are looked up and stored here
+    AnalysisCache *analysis = nullptr;
+    // kept by the caller across the searches of one game
+    SearchContext *context = nullptr;
+
+    bool stopped() const;
+};
+
+Score alphabeta(State& state, unsigned int depth, Score alpha, Score beta, 
+        const SearchControl& control = {});
 
-Action AI_next_move(State& state);
+// iterative deepening up to alphabeta_depth, 
+// returns the best action of the last completed iteration
+Action AI_next_move(State& state, const SearchControl& control = {});
 
 } // namespace gomoku
 } // namespace game
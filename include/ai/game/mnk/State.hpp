@@ -0,0 +1,302 @@
+#ifndef AI_GAME_MNK_STATE_HPP
+#define AI_GAME_MNK_STATE_HPP
+
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <initializer_list>
+#include <ai/game/TranspositionTable.hpp>
+
+namespace ai {
+namespace game {
+namespace mnk {
+
+class Action {
+private:
+    int x_, y_;
+
+public:
+    Action(int x, int y): x_{x}, y_{y} {}
+
+    Action(): Action(0, 0) {}
+
+    int x() const { return x_; }
+
+    int y() const { return y_; }
+};
+
+// the actions of a position, at most one per cell
+template <int Capacity>
+class ActionList {
+private:
+    std::array<Action, Capacity> actions_;
+    int size_ = 0;
+
+public:
+    void push_back(Action action) { actions_[size_++] = action; }
+
+    int size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    const Action& operator [] (int index) const { return actions_[index]; }
+
+    const Action *begin() const { return actions_.data(); }
+
+    const Action *end() const { return actions_.data() + size_; }
+};
+
+// the m,n,k-game: K in a row wins on a board M cells wide and N cells high,
+// the coordinates start from 1 like in tic-tac-toe
+template <int M, int N, int K>
+class State {
+public:
+    static_assert(M > 0 && N > 0 && K > 0 && K <= M && K <= N,
+            "K in a row must fit the board");
+    static_assert((M + 1) * N <= 64, "the board must fit a 64-bit mask");
+
+    enum Player {
+        PLAYER_PERSON,
+        PLAYER_AI,
+        PLAYER_NONE
+    };
+
+    enum CellValue: unsigned char {
+        NONE,
+        X,
+        O
+    };
+
+    using ActionType = Action;
+    using PlayerType = Player;
+
+    static constexpr int width = M;
+    static constexpr int height = N;
+    static constexpr int cell_count = M * N;
+
+private:
+    const Player first_player_;
+    Player next_player_;
+
+    // bit (y - 1) * stride + x - 1 of the cell (x, y), the last bit of each
+    // row is always clear so a shifted line can't wrap into the next row
+    using Mask = std::uint64_t;
+
+    static constexpr int stride = M + 1;
+
+    static constexpr Mask row_mask = (Mask{1} << M) - 1;
+
+    static constexpr Mask full_mask_of(int rows) {
+        return rows == 0 ? 0 : full_mask_of(rows - 1) << stride | row_mask;
+    }
+
+    static constexpr Mask full_mask = full_mask_of(N);
+
+    // horizontal, vertical, first and second diagonal
+    static constexpr int directions[4] = {1, stride, stride + 1, stride - 1};
+
+    Mask x_cells_ = 0;
+    Mask o_cells_ = 0;
+    // the stone of the winner, set by move() from the lines through the stone
+    CellValue winner_ = NONE;
+
+    void switch_player() {
+        switch (next_player()) {
+            case PLAYER_PERSON:
+                next_player_ = PLAYER_AI;
+                break;
+            case PLAYER_AI:
+                next_player_ = PLAYER_PERSON;
+                break;
+            default:
+                break;
+        }
+    }
+
+    CellValue value_of(Player player) const {
+        return player == first_player_ ? X : O;
+    }
+
+    static Mask bit_of(int x, int y) {
+        return Mask{1} << ((y - 1) * stride + x - 1);
+    }
+
+    static Mask bit_of_cell(int index) {
+        return bit_of(index % M + 1, index / M + 1);
+    }
+
+    // whether the cells have K in a row through one of the bits
+    static bool has_line_through(Mask cells, Mask bits) {
+        for (int direction: directions) {
+            // the first cell of every run of K
+            Mask runs = cells;
+            for (int i = 1; i < K; i++)
+                runs &= cells >> (direction * i);
+            Mask covered = runs;
+            for (int i = 1; i < K; i++)
+                covered |= runs << (direction * i);
+            if (covered & bits)
+                return true;
+        }
+        return false;
+    }
+
+    Mask& cells_of(CellValue value) {
+        return value == X ? x_cells_ : o_cells_;
+    }
+
+    float value_of_utility(Player player) const {
+        const float inf = std::numeric_limits<float>::infinity();
+        return player == PLAYER_AI ? inf : -inf;
+    }
+
+    Player next_player_of(Player player) const {
+        switch (player) {
+            case PLAYER_PERSON:
+                return PLAYER_AI;
+            case PLAYER_AI:
+                return PLAYER_PERSON;
+            default:
+                return PLAYER_NONE;
+        }
+    }
+
+    template <typename, typename>
+    friend struct ai::game::StateHash;
+
+public:
+    State(Player first_player)
+        : first_player_{first_player}, next_player_{first_player} {}
+
+    // the cells row by row, the player to move is the first one
+    State(std::initializer_list<CellValue> list, Player first_player)
+        : first_player_{first_player}, next_player_{first_player}
+    {
+        int index = 0;
+        for (auto value: list) {
+            if (value != NONE)
+                cells_of(value) |= bit_of_cell(index);
+            index++;
+        }
+        if (has_line_through(x_cells_, full_mask))
+            winner_ = X;
+        else if (has_line_through(o_cells_, full_mask))
+            winner_ = O;
+    }
+
+    State(const State& other) = default;
+
+    Player next_player() const { return next_player_; }
+
+    CellValue operator () (int x, int y) const {
+        auto bit = bit_of(x, y);
+        if (x_cells_ & bit)
+            return X;
+        return o_cells_ & bit ? O : NONE;
+    }
+
+    void move(Action action) {
+        auto bit = bit_of(action.x(), action.y());
+        auto value = value_of(next_player_);
+        auto& cells = cells_of(value);
+        cells |= bit;
+        if (has_line_through(cells, bit))
+            winner_ = value;
+        switch_player();
+    }
+
+    // a game ends with its first line, so the position before had no winner
+    void unmove(Action action) {
+        auto bit = bit_of(action.x(), action.y());
+        x_cells_ &= ~bit;
+        o_cells_ &= ~bit;
+        winner_ = NONE;
+        switch_player();
+    }
+
+    ActionList<cell_count> legalActions() const {
+        ActionList<cell_count> actions;
+        Mask free = full_mask & ~(x_cells_ | o_cells_);
+        while (free) {
+            int index = __builtin_ctzll(free);
+            actions.push_back(Action{index % stride + 1, index / stride + 1});
+            free &= free - 1;
+        }
+        return actions;
+    }
+
+    // of the cell index y * M + x counted from 0
+    bool on_first_diagonal(int index) const {
+        return index % M == index / M;
+    }
+
+    bool on_second_diagonal(int index) const {
+        return index % M + index / M == M - 1;
+    }
+
+    bool is_terminal(Player& win_player, float& utility) const {
+        if (winner_ != NONE) {
+            win_player = winner_ == X ? first_player_ : next_player_of(first_player_);
+            utility = value_of_utility(win_player);
+            return true;
+        }
+
+        if ((x_cells_ | o_cells_) == full_mask) {
+            win_player = PLAYER_NONE;
+            utility = 0.0f;
+            return true;
+        }
+
+        return false;
+    }
+
+}; // class State
+
+} // namespace mnk
+
+// the cells as a base 3 number while it fits 64 bits, then the player to move,
+// small boards never collide in a table
+template <int M, int N, int K>
+struct StateHash<mnk::State<M, N, K>> {
+    using State = mnk::State<M, N, K>;
+
+    static std::uint64_t mix(std::uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    static constexpr std::array<std::uint64_t, 64> powers_of_three() {
+        std::array<std::uint64_t, 64> powers{};
+        std::uint64_t power = 1;
+        for (int index = 0; index < 64; index++) {
+            // padding bits are never set
+            if (index % State::stride < M) {
+                powers[index] = power;
+                power *= 3;
+            }
+        }
+        return powers;
+    }
+
+    std::uint64_t operator () (const State& state) const {
+        if constexpr (State::cell_count < 40) {
+            static constexpr auto powers = powers_of_three();
+            std::uint64_t hash = 0;
+            for (auto x = state.x_cells_; x; x &= x - 1)
+                hash += powers[__builtin_ctzll(x)];
+            for (auto o = state.o_cells_; o; o &= o - 1)
+                hash += 2 * powers[__builtin_ctzll(o)];
+            return hash * 2 + (state.next_player() == State::PLAYER_AI);
+        }
+        else {
+            auto hash = mix(state.x_cells_) ^ mix(~state.o_cells_);
+            return state.next_player() == State::PLAYER_AI ? ~hash : hash;
+        }
+    }
+};
+
+} // namespace game
+} // namespace ai
+
+#endif // AI_GAME_MNK_STATE_HPP
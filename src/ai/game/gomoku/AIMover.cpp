@@ -1,27 +1,84 @@
 #include <ai/game/gomoku/AIMover.hpp>
-#include <SDL2/SDL_ttf.h>
-
 
 namespace ai {
 namespace game {
 namespace gomoku {
 
-AIMover::AIMover(State& state)
-    : state_{state} {}
+AIMover::AIMover(std::chrono::milliseconds time_limit)
+    : time_limit_{time_limit} 
+{
+    thread_ = std::thread([this]() { run(); });
+}
+
+void AIMover::run() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+        condition_.wait(lock, [this]() { return quit_ || pending_state_; });
+        if (quit_)
+            return;
+
+        auto state = std::move(pending_state_);
+        unsigned int job = job_;
+        searching_ = true;
+        hurry_ = false;
+        cancelled_ = false;
+        lock.unlock();
+
+        SearchControl control;
+        control.stop = &cancelled_;
+        control.deadline = std::chrono::steady_clock::now() + time_limit_;
+        control.report = [this, job](const SearchReport& report) {
+            progress_.publish({job, report});
+        };
+        control.context = &context_;
+        Action action = AI_next_move(*state, control);
+
+        lock.lock();
+        searching_ = false;
+        if (job == job_ && (!cancelled_ || hurry_)) {
+            recent_move_ = action;
+            moved_ = true;
+            thinking_ = false;
+            if (on_moved_)
+                on_moved_();
+        }
+        condition_.notify_all();
+    }
+}
+
+void AIMover::next_move_in_background(const State& state) {
+    auto copy = std::make_unique<State>(state.clone());
 
-void AIMover::next_move_in_background() {
+    std::lock_guard<std::mutex> guard{mutex_};
+    cancelled_ = true;
+    pending_state_ = std::move(copy);
+    job_++;
     moved_ = false;
     thinking_ = true;
+    condition_.notify_all();
+}
 
-    thread_ = std::thread([this]() {
-        Action action = AI_next_move(state_);
-        thinking_ = false;
+void AIMover::move_now() {
+    std::lock_guard<std::mutex> guard{mutex_};
+    if (searching_) {
+        hurry_ = true;
+        cancelled_ = true;
+    }
+}
 
-        std::lock_guard<std::mutex> guard{mutex_};
-        recent_move_ = action;
-        moved_ = true;
-    });
-    thread_.detach();
+void AIMover::stop() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    cancelled_ = true;
+    pending_state_.reset();
+    job_++;
+    thinking_ = false;
+    condition_.wait(lock, [this]() { return !searching_; });
+}
+
+void AIMover::new_game() {
+    stop();
+    std::lock_guard<std::mutex> guard{mutex_};
+    context_.clear();
 }
 
 bool AIMover::moved() {
@@ -31,6 +88,11 @@ bool AIMover::moved() {
     return ret;
 }
 
+void AIMover::on_moved(std::function<void()> callback) {
+    std::lock_guard<std::mutex> guard{mutex_};
+    on_moved_ = std::move(callback);
+}
+
 Action AIMover::recent_move() const {
     std::lock_guard<std::mutex> guard{mutex_};
     return recent_move_;
@@ -40,10 +102,26 @@ bool AIMover::thinking() const {
     return thinking_;
 }
 
+bool AIMover::progress(SearchReport& report) {
+    Progress progress;
+    if (!progress_.read(progress))
+        return false;
+    if (progress.job != job_ || !thinking_)
+        return false;
+    report = progress.report;
+    return true;
+}
+
 AIMover::~AIMover() {
+    {
+        std::lock_guard<std::mutex> guard{mutex_};
+        quit_ = true;
+        cancelled_ = true;
+        condition_.notify_all();
+    }
+    thread_.join();
 }
 
 } // namespace gomoku
 } // namespace game
 } // namespace ai
-
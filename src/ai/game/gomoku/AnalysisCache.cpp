@@ -0,0 +1,221 @@
+#include <ai/game/gomoku/AnalysisCache.hpp>
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+struct AnalysisCache::Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t slot_count;
+};
+
+// check is key ^ data, so a slot torn by a concurrent writer reads as empty
+struct AnalysisCache::Slot {
+    std::uint64_t check;
+    std::uint64_t data;
+};
+
+static const char analysis_magic[4] = {'G', 'M', 'K', 'A'};
+static const std::uint32_t analysis_version = 1;
+
+static const std::size_t header_size = 16;
+
+static bool valid_header(const void *memory, std::size_t size, std::size_t slot_size) {
+    if (size < header_size)
+        return false;
+    auto *magic = static_cast<const char *>(memory);
+    std::uint32_t version;
+    std::uint64_t slot_count;
+    std::memcpy(&version, magic + 4, sizeof(version));
+    std::memcpy(&slot_count, magic + 8, sizeof(slot_count));
+    return std::memcmp(magic, analysis_magic, 4) == 0 
+        && version == analysis_version
+        && slot_count > 0
+        && size == header_size + slot_count * slot_size;
+}
+
+// moves more than 127 cells away from the canonical origin are not stored
+static bool pack(const AnalysisEntry& entry, std::uint64_t& data) {
+    if (entry.best.x < -128 || entry.best.x > 127 
+            || entry.best.y < -128 || entry.best.y > 127 || entry.depth == 0)
+        return false;
+    data = std::uint64_t(std::uint32_t(entry.score))
+        | std::uint64_t(entry.depth) << 32
+        | std::uint64_t(entry.bound) << 40
+        | std::uint64_t(std::uint8_t(entry.best.x)) << 48
+        | std::uint64_t(std::uint8_t(entry.best.y)) << 56;
+    return true;
+}
+
+static AnalysisEntry unpack(std::uint64_t data) {
+    AnalysisEntry entry;
+    entry.score = Score(std::uint32_t(data));
+    entry.depth = (data >> 32) & 0xFF;
+    entry.bound = Bound((data >> 40) & 0xFF);
+    entry.best.x = std::int8_t(data >> 48);
+    entry.best.y = std::int8_t(data >> 56);
+    return entry;
+}
+
+AnalysisCache::AnalysisCache(std::string path, std::size_t capacity)
+    : path_{std::move(path)}, capacity_{capacity} {}
+
+AnalysisCache::~AnalysisCache() {
+    merge();
+    unload();
+}
+
+void AnalysisCache::load() const {
+    static_assert(sizeof(Header) == header_size, "the file layout is fixed");
+    loaded_ = true;
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        std::size_t size = info.st_size;
+        void *memory = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (memory != MAP_FAILED) {
+            if (valid_header(memory, size, sizeof(Slot))) {
+                slots_ = reinterpret_cast<const Slot *>(
+                        static_cast<const char *>(memory) + sizeof(Header));
+                slot_count_ = (size - sizeof(Header)) / sizeof(Slot);
+                mapped_size_ = size;
+            }
+            else {
+                ::munmap(memory, size);
+            }
+        }
+    }
+    ::close(fd);
+}
+
+void AnalysisCache::unload() {
+    if (slots_) {
+        auto *memory = reinterpret_cast<const char *>(slots_) - sizeof(Header);
+        ::munmap(const_cast<char *>(memory), mapped_size_);
+    }
+    slots_ = nullptr;
+    slot_count_ = 0;
+    mapped_size_ = 0;
+    loaded_ = false;
+}
+
+bool AnalysisCache::lookup(std::uint64_t key, AnalysisEntry& entry) const {
+    {
+        std::shared_lock<std::shared_mutex> lock{mutex_};
+        if (loaded_) {
+            bool found = false;
+            auto it = pending_.find(key);
+            if (it != pending_.end()) {
+                entry = it->second;
+                found = true;
+            }
+            for (int i = 0; i < ANALYSIS_CACHE_PROBES && slots_; i++) {
+                auto& slot = slots_[(key + i) % slot_count_];
+                auto data = __atomic_load_n(&slot.data, __ATOMIC_RELAXED);
+                auto check = __atomic_load_n(&slot.check, __ATOMIC_RELAXED);
+                if ((check ^ data) == key && data != 0) {
+                    auto stored = unpack(data);
+                    if (!found || stored.depth > entry.depth)
+                        entry = stored;
+                    return true;
+                }
+            }
+            return found;
+        }
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock{mutex_};
+        if (!loaded_)
+            load();
+    }
+    return lookup(key, entry);
+}
+
+void AnalysisCache::store(std::uint64_t key, const AnalysisEntry& entry) {
+    std::unique_lock<std::shared_mutex> lock{mutex_};
+    auto it = pending_.find(key);
+    if (it == pending_.end() || it->second.depth <= entry.depth)
+        pending_[key] = entry;
+}
+
+bool AnalysisCache::merge() {
+    std::unique_lock<std::shared_mutex> lock{mutex_};
+    if (pending_.empty())
+        return true;
+
+    int fd = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+    // writers take turns, readers of other processes rely on the checks
+    ::flock(fd, LOCK_EX);
+
+    bool merged = false;
+    struct stat info;
+    if (::fstat(fd, &info) == 0) {
+        std::size_t size = info.st_size;
+        if (size == 0) {
+            size = sizeof(Header) + capacity_ * sizeof(Slot);
+            Header header;
+            std::memcpy(header.magic, analysis_magic, 4);
+            header.version = analysis_version;
+            header.slot_count = capacity_;
+            if (::ftruncate(fd, size) != 0 
+                    || ::pwrite(fd, &header, sizeof(header), 0) != sizeof(header))
+                size = 0;
+        }
+        void *memory = size == 0 ? MAP_FAILED 
+            : ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (memory != MAP_FAILED) {
+            if (valid_header(memory, size, sizeof(Slot))) {
+                auto *slots = reinterpret_cast<Slot *>(static_cast<char *>(memory) + sizeof(Header));
+                std::size_t slot_count = (size - sizeof(Header)) / sizeof(Slot);
+                for (auto& e: pending_) {
+                    std::uint64_t data;
+                    if (!pack(e.second, data))
+                        continue;
+                    // the same key, or else the shallowest slot of the probes
+                    Slot *target = nullptr;
+                    for (int i = 0; i < ANALYSIS_CACHE_PROBES; i++) {
+                        auto& slot = slots[(e.first + i) % slot_count];
+                        bool same = (slot.check ^ slot.data) == e.first && slot.data != 0;
+                        if (same) {
+                            target = unpack(slot.data).depth <= e.second.depth ? &slot : nullptr;
+                            break;
+                        }
+                        if (!target || unpack(slot.data).depth < unpack(target->data).depth)
+                            target = &slot;
+                    }
+                    if (target) {
+                        __atomic_store_n(&target->data, data, __ATOMIC_RELAXED);
+                        __atomic_store_n(&target->check, e.first ^ data, __ATOMIC_RELAXED);
+                    }
+                }
+                ::msync(memory, size, MS_SYNC);
+                merged = true;
+            }
+            ::munmap(memory, size);
+        }
+    }
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+
+    if (merged) {
+        pending_.clear();
+        unload();
+    }
+    return merged;
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
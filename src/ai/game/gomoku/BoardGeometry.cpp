@@ -0,0 +1,36 @@
+#include <ai/game/gomoku/BoardGeometry.hpp>
+#include <cmath>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+int modulo(int value, int size) {
+    return (value % size + size) % size;
+}
+
+Coord BoardGeometry::pos_to_coord(Position pos) const {
+    Coord coord;
+    coord.x = screen_width / 2 + pos.x * cell_size + slide.x;
+    coord.y = screen_height / 2 - cell_size - pos.y * cell_size + slide.y;
+    return coord;
+}
+
+Position BoardGeometry::coord_to_pos(Coord coord) const {
+    Position pos;
+    pos.x = std::floor(float(coord.x - screen_width / 2 - slide.x) / cell_size);
+    pos.y = std::floor(float(screen_height / 2 - 1 - coord.y + slide.y) / cell_size);
+    return pos;
+}
+
+// the empty board looks the same when slid by a whole cell
+Coord BoardGeometry::grid_origin() const {
+    return {
+        modulo(screen_width / 2 + slide.x, cell_size) - cell_size,
+        modulo(screen_height / 2 + slide.y, cell_size) - cell_size
+    };
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
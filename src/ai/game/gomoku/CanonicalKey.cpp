@@ -0,0 +1,82 @@
+#include <ai/game/gomoku/CanonicalKey.hpp>
+#include <algorithm>
+#include <climits>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+static Action symmetric_of(Action action, unsigned char symmetry) {
+    if (symmetry & 1)
+        std::swap(action.x, action.y);
+    if (symmetry & 2)
+        action.x = -action.x;
+    if (symmetry & 4)
+        action.y = -action.y;
+    return action;
+}
+
+Action Transform::apply(Action action) const {
+    action = symmetric_of(action, symmetry);
+    return {action.x - offset.x, action.y - offset.y};
+}
+
+Action Transform::inverse(Action action) const {
+    action = {action.x + offset.x, action.y + offset.y};
+    if (symmetry & 4)
+        action.y = -action.y;
+    if (symmetry & 2)
+        action.x = -action.x;
+    if (symmetry & 1)
+        std::swap(action.x, action.y);
+    return action;
+}
+
+// splitmix64 finalizer
+static std::uint64_t mix(std::uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+static std::uint64_t stone_hash(Action action, Cell cell) {
+    auto x = std::uint64_t(std::uint32_t(action.x));
+    auto y = std::uint64_t(std::uint32_t(action.y));
+    return mix((x << 32) ^ (y << 1) ^ (cell == Cell::AI));
+}
+
+CanonicalKey canonical_key_of(const State& state, bool symmetric) {
+    const std::uint64_t ai_to_move = 0x9E3779B97F4A7C15ull;
+    auto& moves = state.moves();
+    std::vector<Action> stones(moves.size());
+
+    CanonicalKey result;
+    for (unsigned char symmetry = 0; symmetry < (symmetric ? 8 : 1); symmetry++) {
+        Transform transform;
+        transform.symmetry = symmetry;
+        transform.offset = {INT_MAX, INT_MAX};
+        for (size_t i = 0; i < moves.size(); i++) {
+            stones[i] = symmetric_of(moves[i], symmetry);
+            transform.offset.x = std::min(transform.offset.x, stones[i].x);
+            transform.offset.y = std::min(transform.offset.y, stones[i].y);
+        }
+        if (moves.empty())
+            transform.offset = {0, 0};
+
+        std::uint64_t hash = state.current_player() == Cell::AI ? ai_to_move : 0;
+        for (size_t i = 0; i < moves.size(); i++) {
+            Action relative{stones[i].x - transform.offset.x, stones[i].y - transform.offset.y};
+            hash ^= stone_hash(relative, state(moves[i].x, moves[i].y));
+        }
+
+        if (symmetry == 0 || hash < result.hash) {
+            result.hash = hash;
+            result.transform = transform;
+        }
+    }
+    return result;
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
@@ -0,0 +1,71 @@
+#include <ai/game/gomoku/EvalCache.hpp>
+#include <ai/game/gomoku/LineMask.hpp>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+struct EvalCacheEntry {
+    std::uint64_t player = 0;
+    std::uint64_t opponent = 0;
+    // ai is the player's score, human the opponent's
+    LineScores scores;
+};
+
+struct EvalCache {
+    EvalCacheEntry entries[EVAL_CACHE_SIZE];
+    EvalCacheStats stats;
+};
+
+static thread_local EvalCache cache;
+
+static std::size_t index_of(std::uint64_t player, std::uint64_t opponent) {
+    auto hash = player * 0x9E3779B97F4A7C15ull ^ opponent * 0xC2B2AE3D27D4EB4Full;
+    return (hash >> 32) % EVAL_CACHE_SIZE;
+}
+
+// both masks empty never get looked up, so they mark unused entries
+static const EvalCacheEntry& entry_of(std::uint64_t player, std::uint64_t opponent) {
+    int shift = __builtin_ctzll(player | opponent);
+    player >>= shift;
+    opponent >>= shift;
+
+    auto& entry = cache.entries[index_of(player, opponent)];
+    if (entry.player == player && entry.opponent == opponent) {
+        cache.stats.hits++;
+        return entry;
+    }
+    cache.stats.misses++;
+    entry.player = player;
+    entry.opponent = opponent;
+    entry.scores = scores_of_masks(player, opponent);
+    return entry;
+}
+
+Score cached_score_of_masks(std::uint64_t player, std::uint64_t opponent) {
+    if (player == 0)
+        return 0;
+    return entry_of(player, opponent).scores.ai;
+}
+
+LineScores cached_scores_of_masks(std::uint64_t ai, std::uint64_t human) {
+    if ((ai | human) == 0)
+        return {};
+    return entry_of(ai, human).scores;
+}
+
+EvalCacheStats eval_cache_stats() {
+    return cache.stats;
+}
+
+void reset_eval_cache_stats() {
+    cache.stats = {};
+}
+
+void clear_eval_cache() {
+    cache = {};
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
@@ -1,4 +1,5 @@
 #include <ai/game/gomoku/InfiniteMatrix.hpp>
+#include <limits>
 
 namespace ai {
 namespace game {
@@ -62,6 +63,29 @@ Frame new_inused_frame(Frame frame, int x, int y) {
     return frame;
 }
 
+static void clip_axis(int p, int d, int low, int size, int& begin, int& end) {
+    if (d == 0) {
+        if (p < low || p >= low + size)
+            end = begin;
+        return;
+    }
+    int first = (low - p) * d;
+    int last = (low + size - 1 - p) * d;
+    if (first > last)
+        std::swap(first, last);
+    begin = std::max(begin, first);
+    end = std::min(end, last + 1);
+}
+
+void clip_line(int x, int y, int dx, int dy, Frame frame, int& begin, int& end) {
+    begin = std::numeric_limits<int>::min();
+    end = std::numeric_limits<int>::max();
+    clip_axis(x, dx, frame.x, frame.w, begin, end);
+    clip_axis(y, dy, frame.y, frame.h, begin, end);
+    if (begin >= end)
+        begin = end = 0;
+}
+
 } // namespace gomoku
 } // namespace game
 } // namespace ai
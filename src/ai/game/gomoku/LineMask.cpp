@@ -0,0 +1,237 @@
+#include <ai/game/gomoku/LineMask.hpp>
+#include <ai/game/gomoku/Heuristic.hpp>
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AI_GOMOKU_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+LineMasks line_masks_scalar(const Cell *cells, int size) {
+    LineMasks masks;
+    for (int i = 0; i < size; i++) {
+        masks.ai |= std::uint64_t(cells[i] == Cell::AI) << i;
+        masks.human |= std::uint64_t(cells[i] == Cell::HUMAN) << i;
+    }
+    return masks;
+}
+
+#ifdef AI_GOMOKU_X86_DISPATCH
+
+// the last chunk overlaps the previous one instead of being copied out
+__attribute__((target("sse2")))
+static LineMasks line_masks_sse2(const Cell *cells, int size) {
+    if (size < 16)
+        return line_masks_scalar(cells, size);
+
+    const __m128i ai = _mm_set1_epi8((char)Cell::AI);
+    const __m128i human = _mm_set1_epi8((char)Cell::HUMAN);
+    LineMasks masks;
+    for (int i = 0; i < size; i += 16) {
+        int offset = std::min(i, size - 16);
+        auto chunk = _mm_loadu_si128((const __m128i *)(cells + offset));
+        std::uint64_t ai_bits = (std::uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, ai));
+        std::uint64_t human_bits = (std::uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, human));
+        masks.ai |= ai_bits << offset;
+        masks.human |= human_bits << offset;
+    }
+    return masks;
+}
+
+__attribute__((target("avx2")))
+static LineMasks line_masks_avx2(const Cell *cells, int size) {
+    if (size < 32)
+        return line_masks_sse2(cells, size);
+
+    const __m256i ai = _mm256_set1_epi8((char)Cell::AI);
+    const __m256i human = _mm256_set1_epi8((char)Cell::HUMAN);
+    LineMasks masks;
+    for (int i = 0; i < size; i += 32) {
+        int offset = std::min(i, size - 32);
+        auto chunk = _mm256_loadu_si256((const __m256i *)(cells + offset));
+        std::uint64_t ai_bits = (std::uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, ai));
+        std::uint64_t human_bits = (std::uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, human));
+        masks.ai |= ai_bits << offset;
+        masks.human |= human_bits << offset;
+    }
+    return masks;
+}
+
+#endif // AI_GOMOKU_X86_DISPATCH
+
+using LineMasksFunction = LineMasks (*)(const Cell *, int);
+
+static LineMasksFunction select_line_masks() {
+#ifdef AI_GOMOKU_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return line_masks_avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return line_masks_sse2;
+#endif
+    return line_masks_scalar;
+}
+
+LineMasks line_masks_of(const Cell *cells, int size) {
+    static const LineMasksFunction function = select_line_masks();
+    return function(cells, size);
+}
+
+LineMasks line_masks_of(const Cell *cells, int size, std::ptrdiff_t stride) {
+    if (stride == 1)
+        return line_masks_of(cells, size);
+    LineMasks masks;
+    for (int i = 0; i < size; i++) {
+        auto cell = cells[i * stride];
+        masks.ai |= std::uint64_t(cell == Cell::AI) << i;
+        masks.human |= std::uint64_t(cell == Cell::HUMAN) << i;
+    }
+    return masks;
+}
+
+static std::uint64_t low_bits(int count) {
+    return count >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << count) - 1;
+}
+
+static bool bit_at(std::uint64_t mask, int index) {
+    return index >= 0 && index < 64 && ((mask >> index) & 1);
+}
+
+// stone count of every five-cell window, no popcnt instruction needed
+static const unsigned char window_counts[1 << MAX_BIT_COUNT] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5
+};
+
+// score_of() of every segment except a five, which depends on cell_count
+struct SegmentScoreTable {
+    Score scores[1 << MAX_BIT_COUNT][3][3];
+
+    SegmentScoreTable() {
+        for (int cells = 0; cells < (1 << MAX_BIT_COUNT); cells++)
+            for (int left = 0; left < 3; left++)
+                for (int right = 0; right < 3; right++) {
+                    SegmentInfo info;
+                    info.cells = cells;
+                    info.distances[0] = SegmentInfo::Distance(left);
+                    info.distances[1] = SegmentInfo::Distance(right);
+                    scores[cells][left][right] = score_of(info);
+                }
+    }
+};
+
+// the player's segment from begin up to the next opponent stone at region_end
+static Score segment_score_at(
+        std::uint64_t player, std::uint64_t opponent, int begin, int region_end)
+{
+    static const SegmentScoreTable table;
+    auto segment = player & low_bits(region_end);
+    int end = 64 - __builtin_clzll(segment);
+
+    int cell_count = end - begin;
+
+    auto cells = (player >> begin) & low_bits(cell_count);
+    if (cell_count > MAX_BIT_COUNT) {
+        // first densest window, skipping the last one like maximum_view()
+        int max = 0, best = 0;
+        for (int offset = 0; offset + MAX_BIT_COUNT < cell_count; offset++) {
+            int count = window_counts[(cells >> offset) & low_bits(MAX_BIT_COUNT)];
+            if (count > max) {
+                max = count;
+                best = offset;
+            }
+        }
+        cells = (cells >> best) & low_bits(MAX_BIT_COUNT);
+    }
+
+    auto left = SegmentInfo::Infinity;
+    if (bit_at(opponent, begin - 1))
+        left = SegmentInfo::Zero;
+    else if (bit_at(opponent, begin - 2))
+        left = SegmentInfo::One;
+
+    auto right = SegmentInfo::Infinity;
+    if (bit_at(opponent, end))
+        right = SegmentInfo::Zero;
+    else if (bit_at(opponent, end + 1))
+        right = SegmentInfo::One;
+
+    if (cells != low_bits(MAX_BIT_COUNT))
+        return table.scores[cells][left][right];
+
+    SegmentInfo info;
+    info.cells = cells;
+    info.cell_count = cell_count;
+    info.distances[0] = left;
+    info.distances[1] = right;
+    return score_of(info);
+}
+
+static int region_end_of(std::uint64_t opponent, int begin) {
+    auto blockers = opponent >> begin;
+    return blockers ? begin + __builtin_ctzll(blockers) : 64;
+}
+
+// the same segments as get_segment_infos(), found with bit scans
+Score score_of_masks(std::uint64_t player, std::uint64_t opponent) {
+    Score result = 0;
+    while (player) {
+        int begin = __builtin_ctzll(player);
+        int region_end = region_end_of(opponent, begin);
+        auto score = segment_score_at(player, opponent, begin, region_end);
+        if (score == win_score)
+            return win_score;
+        result += score;
+        player &= ~low_bits(region_end);
+    }
+    return result;
+}
+
+static void add_score(Score& total, Score score) {
+    total = (total == win_score || score == win_score) ? win_score : total + score;
+}
+
+LineScores scores_of_masks(std::uint64_t ai, std::uint64_t human) {
+    LineScores result;
+    auto stones = ai | human;
+    while (stones) {
+        int begin = __builtin_ctzll(stones);
+        bool is_ai = bit_at(ai, begin);
+        auto player = is_ai ? ai : human;
+        auto opponent = is_ai ? human : ai;
+        int region_end = region_end_of(opponent, begin);
+        add_score(is_ai ? result.ai : result.human,
+                segment_score_at(player, opponent, begin, region_end));
+        stones &= ~low_bits(region_end);
+    }
+    return result;
+}
+
+static int trailing_ones(std::uint64_t mask) {
+    return ~mask ? __builtin_ctzll(~mask) : 64;
+}
+
+static int leading_ones(std::uint64_t mask) {
+    return ~mask ? __builtin_clzll(~mask) : 64;
+}
+
+bool is_five_through(std::uint64_t player, std::uint64_t opponent, int index) {
+    int up = trailing_ones(player >> index);
+    if (up == 0)
+        return false;
+    int down = leading_ones(player << (63 - index));
+    int count = up + down - 1;
+    if (count != 5)
+        return count > 5;
+    int begin = index - down + 1;
+    int end = index + up;
+    return !(bit_at(opponent, begin - 1) && bit_at(opponent, end));
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
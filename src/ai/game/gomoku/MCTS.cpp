@@ -0,0 +1,233 @@
+#include <ai/game/gomoku/MCTS.hpp>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+// rewards are fixed point in [0, reward_one]
+static const std::int64_t reward_one = 1 << 16;
+
+struct MCTSNode {
+    enum Expansion: unsigned char {
+        Leaf, Expanding, Expanded
+    };
+
+    Action action = {0, 0};
+    // includes the virtual losses of playouts in flight
+    std::atomic_int visits{0};
+    // for the player who moved into the node
+    std::atomic<std::int64_t> reward{0};
+    std::atomic<Expansion> expansion{Leaf};
+    unsigned int first_child = 0;
+    unsigned int child_count = 0;
+};
+
+class MCTSTree {
+private:
+    const MCTSOptions& options_;
+    std::unique_ptr<MCTSNode[]> nodes_;
+    std::atomic_uint size_{1};
+
+public:
+    std::atomic_uint playouts{0};
+    std::atomic_uint max_depth{0};
+
+    MCTSTree(const MCTSOptions& options)
+        : options_{options}, nodes_{new MCTSNode[options.max_nodes]} {}
+
+    MCTSNode& root() { return nodes_[0]; }
+
+    MCTSNode& child(const MCTSNode& node, unsigned int i) { 
+        return nodes_[node.first_child + i]; 
+    }
+
+    // one thread wins the expansion, the others keep treating the node as a leaf
+    void expand(MCTSNode& node, State& state);
+
+    MCTSNode& select(MCTSNode& node);
+};
+
+void MCTSTree::expand(MCTSNode& node, State& state) {
+    auto expected = MCTSNode::Leaf;
+    if (!node.expansion.compare_exchange_strong(expected, MCTSNode::Expanding))
+        return;
+
+    auto actions = state.forcing_actions();
+    if (actions.empty())
+        actions = state.ordered_actions(options_.branching);
+    // nothing to play, the node stays a leaf for good
+    if (actions.empty())
+        return;
+
+    unsigned int first = size_.fetch_add(actions.size());
+    if (first + actions.size() > options_.max_nodes) {
+        // full, the node stays a leaf for good
+        return;
+    }
+    for (size_t i = 0; i < actions.size(); i++)
+        nodes_[first + i].action = actions[i];
+    node.first_child = first;
+    node.child_count = actions.size();
+    node.expansion.store(MCTSNode::Expanded, std::memory_order_release);
+}
+
+// an expanded node, which always has children
+MCTSNode& MCTSTree::select(MCTSNode& node) {
+    assert (node.child_count > 0);
+    float log_visits = std::log(float(node.visits.load(std::memory_order_relaxed)) + 1);
+    MCTSNode *best = nullptr;
+    float best_value = -1;
+    for (unsigned int i = 0; i < node.child_count; i++) {
+        auto& c = child(node, i);
+        int visits = c.visits.load(std::memory_order_relaxed);
+        // unvisited children go first, in heuristic order
+        if (visits == 0)
+            return c;
+        float mean = float(c.reward.load(std::memory_order_relaxed)) / reward_one / visits;
+        float value = mean + options_.exploration * std::sqrt(log_visits / visits);
+        if (value > best_value) {
+            best_value = value;
+            best = &c;
+        }
+    }
+    assert (best);
+    return *best;
+}
+
+// AI's reward of the position, hvalue() squashed when nobody has won yet
+static std::int64_t ai_reward_of(const State& state) {
+    if (state.is_terminal())
+        return is_win(state.hvalue()) ? reward_one : 0;
+    float squashed = std::tanh(float(state.hvalue()) / (64 * SCORE_SCALE));
+    return std::int64_t((0.5f + 0.5f * squashed) * reward_one);
+}
+
+static std::int64_t playout(State& state, const MCTSOptions& options, std::mt19937& random) {
+    unsigned int moves = 0;
+    while (moves < options.playout_depth && !state.is_terminal()) {
+        auto actions = state.ordered_actions(options.playout_width);
+        if (actions.empty())
+            break;
+        std::uniform_int_distribution<size_t> index{0, actions.size() - 1};
+        state.move(actions[index(random)]);
+        moves++;
+    }
+    auto reward = ai_reward_of(state);
+    while (moves--)
+        state.unmove();
+    return reward;
+}
+
+static void search(MCTSTree& tree, State& state, const SearchControl& control, 
+        const MCTSOptions& options, unsigned int seed)
+{
+    std::mt19937 random{seed};
+    std::vector<MCTSNode *> path;
+    while (!control.stopped() && tree.playouts.fetch_add(1) < options.max_playouts) {
+        auto *node = &tree.root();
+        node->visits++;
+        path.clear();
+        while (node->expansion.load(std::memory_order_acquire) == MCTSNode::Expanded
+                && !state.is_terminal()) {
+            node = &tree.select(*node);
+            // a virtual loss until the reward is added
+            node->visits++;
+            path.push_back(node);
+            state.move(node->action);
+        }
+        if (!state.is_terminal())
+            tree.expand(*node, state);
+
+        auto ai_reward = playout(state, options, random);
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            state.unmove();
+            // the player to move now has played the node's action
+            bool by_ai = state.current_player() == Cell::AI;
+            (*it)->reward += by_ai ? ai_reward : reward_one - ai_reward;
+        }
+
+        auto depth = path.size();
+        auto max_depth = tree.max_depth.load();
+        while (depth > max_depth && !tree.max_depth.compare_exchange_weak(max_depth, depth))
+            ;
+    }
+}
+
+static Action most_visited(MCTSTree& tree) {
+    auto& root = tree.root();
+    assert (root.child_count > 0);
+    auto *best = &tree.child(root, 0);
+    for (unsigned int i = 1; i < root.child_count; i++) {
+        auto& c = tree.child(root, i);
+        if (c.visits > best->visits)
+            best = &c;
+    }
+    return best->action;
+}
+
+Action MCTS_next_move(State& state, const SearchControl& control, 
+        const MCTSOptions& options)
+{
+    const auto start = std::chrono::steady_clock::now();
+    MCTSTree tree{options};
+    tree.expand(tree.root(), state);
+    auto& root = tree.root();
+    // the arena can't even hold the children of the root
+    if (root.child_count == 0) {
+        auto actions = state.ordered_actions(1);
+        assert (!actions.empty());
+        return actions[0];
+    }
+    if (root.child_count == 1)
+        return tree.child(root, 0).action;
+
+    unsigned int threads = options.threads;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<State> states;
+    states.reserve(threads);
+    for (unsigned int i = 0; i < threads; i++)
+        states.push_back(state.clone());
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; i++)
+        workers.emplace_back([&, i]() { search(tree, states[i], control, options, i); });
+    search(tree, states[0], control, options, 0);
+    for (auto& worker: workers)
+        worker.join();
+
+    auto best = most_visited(tree);
+    if (control.report) {
+        SearchReport report;
+        report.best = best;
+        report.depth = tree.max_depth;
+        for (unsigned int i = 0; i < root.child_count; i++) {
+            auto& c = tree.child(root, i);
+            if (c.action == best && c.visits > 0) {
+                // the win rate mapped onto +-512 points
+                float rate = float(c.reward) / reward_one / c.visits;
+                report.score = Score((rate - 0.5f) * 1024 * SCORE_SCALE);
+            }
+        }
+        report.cache = eval_cache_stats();
+        report.nodes = std::min(tree.playouts.load(), options.max_playouts);
+        report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+        control.report(report);
+    }
+    return best;
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
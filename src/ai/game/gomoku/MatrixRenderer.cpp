@@ -1,47 +1,65 @@
 #include <ai/game/gomoku/MatrixRenderer.hpp>
-#include <cmath>
 #include <SDL2/SDL_image.h>
 
 namespace ai {
 namespace game {
 namespace gomoku {
 
+static std::uint64_t packed(Position pos) {
+    return std::uint64_t(std::uint32_t(pos.x)) << 32 | std::uint32_t(pos.y);
+}
+
 MatrixRenderer::MatrixRenderer(
         SDL_Renderer *renderer,
-        int matrix_size,
         int screen_width, 
         int screen_height) 
 : 
     renderer_{renderer},
-    matrix_size{matrix_size}, 
     screen_width{screen_width}, 
     screen_height{screen_height} 
 {
-    matrix_.resize(matrix_size * matrix_size);
-
     N = IMG_LoadTexture(renderer_, "assets/N.png");
     N_gray = IMG_LoadTexture(renderer_, "assets/N_gray.png");
     O = IMG_LoadTexture(renderer_, "assets/O.png");
     X = IMG_LoadTexture(renderer_, "assets/X.png");
     X_gray = IMG_LoadTexture(renderer_, "assets/X_gray.png");
 
+    grid_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888, 
+            SDL_TEXTUREACCESS_TARGET, 
+            (screen_width / cell_size + 2) * cell_size, 
+            (screen_height / cell_size + 2) * cell_size);
+
     reset();
 }
 
 SDL_Texture *MatrixRenderer::operator () (Position pos) const {
-    int i = matrix_size / 2 - pos.y - 1;
-    int j = pos.x + matrix_size / 2;
-    return matrix_[j + i * matrix_size];
+    auto it = stones_.find(packed(pos));
+    return it == stones_.end() ? N : it->second.texture;
 }
 
-SDL_Texture *& MatrixRenderer::operator () (Position pos) {
-    int i = matrix_size / 2 - pos.y - 1;
-    int j = pos.x + matrix_size / 2;
-    return matrix_[j + i * matrix_size];
+void MatrixRenderer::set(Position pos, SDL_Texture *texture) {
+    if (texture == N)
+        stones_.erase(packed(pos));
+    else
+        stones_[packed(pos)] = {pos, texture};
 }
 
 void MatrixRenderer::reset() {
-    std::fill(matrix_.begin(), matrix_.end(), N);
+    stones_.clear();
+    redraw();
+}
+
+void MatrixRenderer::redraw() {
+    if (!grid_)
+        return;
+    SDL_SetRenderTarget(renderer_, grid_);
+    SDL_RenderClear(renderer_);
+    for (int i = 0; i < screen_height / cell_size + 2; i++)
+        for (int j = 0; j < screen_width / cell_size + 2; j++) {
+            SDL_Rect rect{j * cell_size, i * cell_size, cell_size, cell_size};
+            SDL_RenderCopy(renderer_, N, nullptr, &rect);
+        }
+    SDL_SetRenderTarget(renderer_, nullptr);
 }
 
 void MatrixRenderer::begin_slide() {
@@ -53,39 +71,60 @@ void MatrixRenderer::slide(Coord dv) {
     slide_vector_.y = old_slide_vector_.y + dv.y;
 }
 
-void MatrixRenderer::render() const {
-    for (int x = -matrix_size / 2; x < matrix_size / 2; x++)
-        for (int y = -matrix_size / 2; y < matrix_size / 2; y++) {
-            auto coord = pos_to_coord({x, y});
-            SDL_Rect rect{coord.x, coord.y, cell_size, cell_size};
-            SDL_RenderCopy(renderer_, (*this)(Position{x, y}), nullptr, &rect);
+void MatrixRenderer::render_grid() const {
+    auto origin = geometry().grid_origin();
+    int left = origin.x;
+    int top = origin.y;
+
+    if (grid_) {
+        int w, h;
+        SDL_QueryTexture(grid_, nullptr, nullptr, &w, &h);
+        SDL_Rect rect{left, top, w, h};
+        SDL_RenderCopy(renderer_, grid_, nullptr, &rect);
+        return;
+    }
+
+    for (int y = top; y < screen_height; y += cell_size)
+        for (int x = left; x < screen_width; x += cell_size) {
+            SDL_Rect rect{x, y, cell_size, cell_size};
+            SDL_RenderCopy(renderer_, N, nullptr, &rect);
         }
 }
 
-Coord MatrixRenderer::pos_to_coord(Position pos) const {
-    Coord coord;
-    coord.x = screen_width / 2 + pos.x * cell_size + slide_vector_.x;
-    coord.y = screen_height / 2 - cell_size 
-        - pos.y * cell_size + slide_vector_.y;
-    return coord;
+// the stones are drawn over a cleared cell, as their textures may 
+// have transparent parts
+void MatrixRenderer::render() const {
+    render_grid();
+
+    for (auto& entry: stones_) {
+        auto coord = pos_to_coord(entry.second.pos);
+        if (coord.x + cell_size <= 0 || coord.x >= screen_width 
+                || coord.y + cell_size <= 0 || coord.y >= screen_height)
+            continue;
+        SDL_Rect rect{coord.x, coord.y, cell_size, cell_size};
+        SDL_RenderFillRect(renderer_, &rect);
+        SDL_RenderCopy(renderer_, entry.second.texture, nullptr, &rect);
+    }
 }
 
-Position MatrixRenderer::coord_to_pos(Coord coord) const {
-    Position pos;
-    pos.x = std::floor(float(coord.x - screen_width / 2 
-                - slide_vector_.x) / cell_size);
-    pos.y = std::floor(float(screen_height / 2 - 1 
-                - coord.y + slide_vector_.y) / cell_size);
-    return pos;
+void MatrixRenderer::highlight(Position pos, SDL_Color color) const {
+    auto coord = pos_to_coord(pos);
+    SDL_Rect rect{coord.x, coord.y, cell_size, cell_size};
+    SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, color.a);
+    SDL_RenderDrawRect(renderer_, &rect);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
 }
 
 MatrixRenderer::~MatrixRenderer() {
+    if (grid_)
+        SDL_DestroyTexture(grid_);
     SDL_DestroyTexture(N);
+    SDL_DestroyTexture(N_gray);
     SDL_DestroyTexture(O);
     SDL_DestroyTexture(X);
+    SDL_DestroyTexture(X_gray);
 }
 
 } // namespace gomoku
 } // namespace game
 } // namespace ai
-
@@ -23,7 +23,7 @@ bool MoveOrderer::actions_stored() const {
 void MoveOrderer::sort() {
 }
 
-void MoveOrderer::add_action(Action action, float hvalue) {
+void MoveOrderer::add_action(Action action, Score hvalue) {
     actions_map_[move_stack_].push_back({action, hvalue});
 }
 
@@ -2,16 +2,17 @@
 #include <algorithm>
 #include <SDL2/SDL_ttf.h>
 #include <cassert>
+#include <cstdio>
 
 namespace ai {
 namespace game {
 namespace gomoku {
 
 void SDLWrapper::move(Action action) {
-    (*matrix_renderer_)(action) = player_to_cell(state().current_player());
+    matrix_renderer_->set(action, player_to_cell(state().current_player()));
     if (state().current_player() == Cell::HUMAN) {
         if (game_->ai_prev_move_.has_value())
-            (*matrix_renderer_)(game_->ai_prev_move_.value()) = matrix_renderer_->X;
+            matrix_renderer_->set(game_->ai_prev_move_.value(), matrix_renderer_->X);
     }
     else {
         game_->ai_prev_move_ = action;
@@ -20,17 +21,18 @@ void SDLWrapper::move(Action action) {
 }
 
 void SDLWrapper::next_game() {
+    ai_mover_->new_game();
+
     matrix_renderer_->reset();
     start_player_ = inverse_of(start_player_);
     game_ = std::make_unique<Game>(start_player_);
-    ai_mover_ = std::make_unique<AIMover>(game_->state_);
 
     if (start_player_ == Cell::AI) {
         auto action = AI_next_move(state());
         move(action);
     }
     else {
-        (*matrix_renderer_)({0, 0}) = matrix_renderer_->N_gray;
+        matrix_renderer_->set({0, 0}, matrix_renderer_->N_gray);
     }
 
     may_drag_ = false;
@@ -63,7 +65,9 @@ void SDLWrapper::handle_human_move(Position pos) {
         return;
     }
 
-    ai_mover_->next_move_in_background();
+    ai_mover_->next_move_in_background(state());
+    has_report_ = false;
+    thinking_since_ = SDL_GetTicks();
 }
 
 bool SDLWrapper::handle_game_mouse_event(SDL_Event event) {
@@ -118,14 +122,16 @@ void SDLWrapper::init_texts() {
 }
 
 void SDLWrapper::display_texts() {
-    guide_->render();
+    text_->render("F5 to reset", matrix_renderer_->screen_width - 100, 15);
 
-    if (ai_mover_->thinking())
-        ai_thinking_->render();
+    if (ai_mover_->thinking()) {
+        text_->render("AI thinking...", 10, 560);
+        display_overlay();
+    }
     if (game_->ai_won_displayed_)
-        ai_won_->render();
+        text_->render("AI won!", 10, 15);
     if (game_->you_won_displayed_)
-        you_won_->render();
+        text_->render("you won!", 10, 15);
 }
 
 SDLWrapper::SDLWrapper() {
@@ -139,89 +145,216 @@ SDLWrapper::SDLWrapper() {
             "Gomoku", 100, 100, screen_width, screen_height, 0);
 
     renderer_ = SDL_CreateRenderer(
-            window_, -1, SDL_RENDERER_ACCELERATED);
+            window_, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC 
+            | SDL_RENDERER_TARGETTEXTURE);
 
     init_texts();
 
     matrix_renderer_ = std::make_unique<MatrixRenderer>(renderer_, screen_width, screen_height);
+    ai_mover_ = std::make_unique<AIMover>();
+
+    ai_moved_event_ = SDL_RegisterEvents(1);
+    ai_mover_->on_moved([event_type = ai_moved_event_]() {
+        SDL_Event event = {};
+        event.type = event_type;
+        SDL_PushEvent(&event);
+    });
 
-    ai_thinking_ = std::make_unique<TextRenderer>(
-            Sans_, renderer_, "AI thinking...", SDL_Color{255, 255, 255, 255}, 10, 560);
+    text_ = std::make_unique<GlyphAtlas>(
+            Sans_, renderer_, SDL_Color{255, 255, 255, 255});
 
-    ai_won_ = std::make_unique<TextRenderer>(
-            Sans_, renderer_, "AI won!", SDL_Color{255, 255, 255, 255}, 10, 15);
+    next_game();
+}
 
-    you_won_ = std::make_unique<TextRenderer>(
-            Sans_, renderer_, "you won!", SDL_Color{255, 255, 255, 255}, 10, 15);
+void SDLWrapper::handle_ai_move() {
+    if (!ai_mover_->moved())
+        return;
 
-    guide_ = std::make_unique<TextRenderer>(
-            Sans_, renderer_, "F5 to reset", SDL_Color{255, 255, 255, 255}, 
-            screen_width - 100, 15);
+    auto action = ai_mover_->recent_move();
+    move(action);
 
-    next_game();
+    if (state().is_terminal()) {
+        game_->ai_won_displayed_ = true;
+        game_->going_to_next_game_ = true;
+    }
+    dirty_ = true;
+}
+
+// polls the search's mailbox, nothing is locked
+void SDLWrapper::update_overlay() {
+    if (!ai_mover_->thinking())
+        return;
+    auto now = SDL_GetTicks();
+    if (now - last_overlay_ < OVERLAY_INTERVAL_MS)
+        return;
+    last_overlay_ = now;
+
+    SearchReport report;
+    if (ai_mover_->progress(report)) {
+        report_ = report;
+        has_report_ = true;
+    }
+    // the clock moves on anyway
+    dirty_ = true;
+}
+
+void SDLWrapper::display_overlay() {
+    char line[64];
+    int x = 10, y = 470;
+    double seconds = (SDL_GetTicks() - thinking_since_) / 1000.0;
+    std::snprintf(line, sizeof(line), "%.1f s", seconds);
+    y += text_->render(line, x, y);
+    if (!has_report_)
+        return;
+
+    matrix_renderer_->highlight(report_.best, SDL_Color{255, 200, 0, 255});
+
+    auto elapsed = report_.elapsed.count();
+    double nodes_per_second = elapsed > 0 ? report_.nodes * 1000.0 / elapsed : 0.0;
+    std::snprintf(line, sizeof(line), "depth %u  %.0f nodes/s", 
+            report_.depth, nodes_per_second);
+    y += text_->render(line, x, y);
+
+    if (is_win(report_.score))
+        std::snprintf(line, sizeof(line), "best (%d, %d)  AI wins", 
+                report_.best.x, report_.best.y);
+    else if (is_loss(report_.score))
+        std::snprintf(line, sizeof(line), "best (%d, %d)  AI loses", 
+                report_.best.x, report_.best.y);
+    else
+        std::snprintf(line, sizeof(line), "best (%d, %d)  score %.2f", 
+                report_.best.x, report_.best.y, double(report_.score) / SCORE_SCALE);
+    text_->render(line, x, y);
+}
+
+bool SDLWrapper::handle_event(const SDL_Event& event) {
+    if (event.type == SDL_QUIT)
+        return false;
+    if (event.type == SDL_KEYDOWN) {
+        if (event.key.keysym.sym == SDLK_F5)
+            next_game();
+    }
+    if (event.type == SDL_RENDER_TARGETS_RESET)
+        matrix_renderer_->redraw();
+    handle_game_mouse_event(event);
+
+    // hovering doesn't change the picture
+    if (event.type != SDL_MOUSEMOTION || dragging_)
+        dirty_ = true;
+    return true;
 }
 
+void SDLWrapper::render_frame() {
+    SDL_RenderClear(renderer_);
+    matrix_renderer_->render();
+    display_texts();
+    SDL_RenderPresent(renderer_);
+
+    dirty_ = false;
+    last_frame_ = SDL_GetTicks();
+}
+
+// sleeps until an event arrives, drains every pending event, then draws
+// at most one frame per FRAME_INTERVAL_MS, only when something changed
 void SDLWrapper::run() {
     while (true) {
-        if (ai_mover_->moved()) {
-            auto action = ai_mover_->recent_move();
-            move(action);
-
-            if (state().is_terminal()) {
-                game_->ai_won_displayed_ = true;
-                game_->going_to_next_game_ = true;
-            }
+        int timeout = ai_mover_->thinking() ? OVERLAY_INTERVAL_MS : IDLE_WAIT_MS;
+        if (dirty_) {
+            int elapsed = SDL_GetTicks() - last_frame_;
+            if (elapsed >= FRAME_INTERVAL_MS)
+                render_frame();
+            else
+                timeout = FRAME_INTERVAL_MS - elapsed;
         }
 
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT)
-                return;
-            if (event.type == SDL_KEYDOWN) {
-                if (event.key.keysym.sym == SDLK_F5)
-                    next_game();
-            }
-            handle_game_mouse_event(event);
+        if (SDL_WaitEventTimeout(&event, timeout)) {
+            do {
+                if (!handle_event(event))
+                    return;
+            } while (SDL_PollEvent(&event));
         }
 
-        SDL_RenderClear(renderer_);
-        matrix_renderer_->render();
-        display_texts();
-        SDL_RenderPresent(renderer_);
+        handle_ai_move();
+        update_overlay();
     }
 }
 
 SDLWrapper::~SDLWrapper() {
+    ai_mover_.reset();
+    text_.reset();
     SDL_DestroyRenderer(renderer_);
     SDL_DestroyWindow(window_);
 }
 
-// Text Renderer
-TextRenderer::TextRenderer(TTF_Font *font, 
-        SDL_Renderer *renderer,
-        const std::string& string, 
-        SDL_Color color,
-        int x, int y)
+// Glyph Atlas
+GlyphAtlas::GlyphAtlas(TTF_Font *font, SDL_Renderer *renderer, SDL_Color color)
+    : renderer_{renderer}
 {
-    renderer_ = renderer;
-    auto surface = TTF_RenderText_Solid(font, string.c_str(), color);
-
-    texture_ = SDL_CreateTextureFromSurface(renderer_, surface);
-    assert(texture_ != nullptr);
-
-    rect_.x = x;
-    rect_.y = y;
-    rect_.w = surface->w;
-    rect_.h = surface->h;
+    const int atlas_width = 512;
+    height_ = TTF_FontHeight(font);
+
+    // rows of glyphs, left to right
+    SDL_Surface *surfaces[128] = {};
+    int x = 0, y = 0, row_height = 0;
+    for (int c = ' '; c <= '~'; c++) {
+        auto surface = TTF_RenderGlyph_Blended(font, Uint16(c), color);
+        if (!surface)
+            continue;
+        if (x + surface->w > atlas_width) {
+            x = 0;
+            y += row_height;
+            row_height = 0;
+        }
+        surfaces[c] = surface;
+        glyphs_[c].source = {x, y, surface->w, surface->h};
+        x += surface->w;
+        row_height = std::max(row_height, surface->h);
+
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font, Uint16(c), &minx, &maxx, &miny, &maxy, &advance) == 0)
+            glyphs_[c].advance = advance;
+        else
+            glyphs_[c].advance = surface->w;
+    }
 
-    SDL_FreeSurface(surface);
+    auto atlas = SDL_CreateRGBSurfaceWithFormat(
+            0, atlas_width, y + row_height, 32, SDL_PIXELFORMAT_ARGB8888);
+    for (int c = ' '; c <= '~'; c++) {
+        if (!surfaces[c])
+            continue;
+        if (atlas) {
+            // copies the alpha channel instead of blending it away
+            SDL_SetSurfaceBlendMode(surfaces[c], SDL_BLENDMODE_NONE);
+            auto target = glyphs_[c].source;
+            SDL_BlitSurface(surfaces[c], nullptr, atlas, &target);
+        }
+        SDL_FreeSurface(surfaces[c]);
+    }
+    if (!atlas)
+        throw std::runtime_error(SDL_GetError());
+
+    texture_ = SDL_CreateTextureFromSurface(renderer_, atlas);
+    SDL_FreeSurface(atlas);
+    if (!texture_)
+        throw std::runtime_error(SDL_GetError());
+    SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
 }
 
-void TextRenderer::render() {
-    SDL_RenderCopy(renderer_, texture_, nullptr, &rect_);
+int GlyphAtlas::render(const char *text, int x, int y) const {
+    for (; *text; text++) {
+        unsigned char c = *text;
+        auto& glyph = glyphs_[c < 128 ? c : '?'];
+        if (glyph.source.w > 0) {
+            SDL_Rect target{x, y, glyph.source.w, glyph.source.h};
+            SDL_RenderCopy(renderer_, texture_, &glyph.source, &target);
+        }
+        x += glyph.advance;
+    }
+    return height_;
 }
 
-TextRenderer::~TextRenderer() {
+GlyphAtlas::~GlyphAtlas() {
     SDL_DestroyTexture(texture_);
 }
 
@@ -0,0 +1,82 @@
+#include <ai/game/gomoku/SearchContext.hpp>
+#include <algorithm>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+static std::uint64_t packed(Action action) {
+    return std::uint64_t(std::uint32_t(action.x)) << 32 | std::uint32_t(action.y);
+}
+
+static std::size_t power_of_two_below(std::size_t size) {
+    std::size_t result = 1;
+    while (result * 2 <= size)
+        result *= 2;
+    return result;
+}
+
+SearchContext::SearchContext(std::size_t table_size)
+    : table_(power_of_two_below(table_size)) {}
+
+const TranspositionEntry *SearchContext::probe(std::uint64_t key) const {
+    auto& entry = table_[key & (table_.size() - 1)];
+    if (entry.key != key || entry.depth == 0)
+        return nullptr;
+    return &entry;
+}
+
+void SearchContext::store(std::uint64_t key, Score score, unsigned int depth, 
+        Bound bound, Action best)
+{
+    auto& entry = table_[key & (table_.size() - 1)];
+    if (entry.key == key || entry.generation != generation_ || entry.depth <= depth)
+        entry = {key, score, (unsigned char)depth, bound, generation_, best};
+}
+
+void SearchContext::reward(Action action, unsigned int depth) {
+    history_[packed(action)] += depth * depth;
+}
+
+unsigned int SearchContext::history(Action action) const {
+    auto it = history_.find(packed(action));
+    return it == history_.end() ? 0 : it->second;
+}
+
+void SearchContext::next_search() {
+    generation_++;
+}
+
+void SearchContext::set_principal_variation(std::vector<Action> actions, 
+        std::vector<std::uint64_t> keys)
+{
+    principal_variation_ = std::move(actions);
+    principal_keys_ = std::move(keys);
+}
+
+bool SearchContext::expected_reply(Action& action) const {
+    if (principal_variation_.size() < 2)
+        return false;
+    action = principal_variation_[1];
+    return true;
+}
+
+bool SearchContext::principal_move(std::uint64_t key, Action& action) const {
+    auto it = std::find(principal_keys_.begin(), principal_keys_.end(), key);
+    if (it == principal_keys_.end())
+        return false;
+    action = principal_variation_[it - principal_keys_.begin()];
+    return true;
+}
+
+void SearchContext::clear() {
+    std::fill(table_.begin(), table_.end(), TranspositionEntry{});
+    history_.clear();
+    principal_variation_.clear();
+    principal_keys_.clear();
+    generation_ = 0;
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
@@ -1,9 +1,15 @@
 #include <ai/game/gomoku/State.hpp>
 #include <ai/game/gomoku/Heuristic.hpp>
+#include <ai/game/gomoku/LineMask.hpp>
+#include <ai/game/gomoku/EvalCache.hpp>
+#include <ai/game/gomoku/AnalysisCache.hpp>
+#include <ai/game/gomoku/CanonicalKey.hpp>
+#include <ai/game/gomoku/SearchContext.hpp>
 #include <algorithm>
 #include <gsl/gsl>
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
 
 namespace ai {
 namespace game {
@@ -13,10 +19,105 @@ bool operator == (Action action1, Action action2) {
     return action1.x == action2.x && action1.y == action2.y;
 }
 
+// the empty board only allows the origin, the stones allow the cells after
 State::State(Cell start_player): current_player_{start_player} {
     allow_cells_(0, 0) = 1;
-    terminated_stack_.push(false);
-    hvalue_stack_.push(0.0f);
+    terminated_stack_.push_back(false);
+    hvalue_stack_.push_back(0);
+}
+
+State::State(const Snapshot& snapshot): State(snapshot.start_player) {
+    if (snapshot.start_player != Cell::AI && snapshot.start_player != Cell::HUMAN)
+        throw std::invalid_argument("invalid snapshot start player");
+    for (auto action: snapshot.moves) {
+        if (is_terminal())
+            throw std::invalid_argument("snapshot move after the game is over");
+        if (!is_legal(action))
+            throw std::invalid_argument("illegal snapshot move");
+        move(action);
+    }
+}
+
+State::State(const State& other, int margin)
+:
+    cells_{other.cells_.compact_copy(margin)},
+    allow_cells_{other.allow_cells_.compact_copy(margin)},
+    current_player_{other.current_player_},
+    move_stack_{other.move_stack_},
+    terminated_stack_{other.terminated_stack_},
+    hvalue_stack_{other.hvalue_stack_},
+    hash_{other.hash_},
+    threats_{other.threats_.compact_copy(margin)},
+    threat_log_{other.threat_log_},
+    threat_marks_{other.threat_marks_}
+{
+}
+
+State State::clone() const {
+    return State{*this, threat_radius};
+}
+
+Snapshot State::snapshot() const {
+    Snapshot snapshot;
+    snapshot.start_player = move_stack_.size() % 2 == 0 
+        ? current_player_ : inverse_of(current_player_);
+    snapshot.moves = move_stack_;
+    return snapshot;
+}
+
+static void put_varint(std::string& data, int value) {
+    auto zigzag = ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+    while (zigzag >= 0x80) {
+        data.push_back(char(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    data.push_back(char(zigzag));
+}
+
+static int get_varint(const std::string& data, size_t& index) {
+    unsigned int zigzag = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (index >= data.size())
+            throw std::invalid_argument("truncated snapshot");
+        auto byte = (unsigned char)data[index++];
+        // the fifth byte only has room for the top 4 bits
+        if (shift == 28 && (byte & 0x70))
+            throw std::invalid_argument("malformed snapshot");
+        zigzag |= (unsigned int)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return int(zigzag >> 1) ^ -int(zigzag & 1);
+    }
+    throw std::invalid_argument("malformed snapshot");
+}
+
+std::string serialize(const Snapshot& snapshot) {
+    std::string data;
+    data.reserve(1 + snapshot.moves.size() * 2);
+    data.push_back((char)snapshot.start_player);
+    for (auto action: snapshot.moves) {
+        put_varint(data, action.x);
+        put_varint(data, action.y);
+    }
+    return data;
+}
+
+Snapshot deserialize(const std::string& data) {
+    if (data.empty())
+        throw std::invalid_argument("empty snapshot");
+
+    Snapshot snapshot;
+    snapshot.start_player = (Cell)data[0];
+    if (snapshot.start_player != Cell::AI && snapshot.start_player != Cell::HUMAN)
+        throw std::invalid_argument("malformed snapshot");
+
+    size_t index = 1;
+    while (index < data.size()) {
+        Action action;
+        action.x = get_varint(data, index);
+        action.y = get_varint(data, index);
+        snapshot.moves.push_back(action);
+    }
+    return snapshot;
 }
 
 std::vector<Action> State::legal_actions() const {
@@ -25,180 +126,520 @@ std::vector<Action> State::legal_actions() const {
     auto inused = allow_cells_.inused();
     for (int x = inused.x; x < inused.x + inused.w; x++)
         for (int y = inused.y; y < inused.y + inused.h; y++) {
-            if (allow_cells_(x, y) != 0 && cells_(x, y) == Cell::NONE)
+            if (allow_cells_(x, y) != 0 && cells_.get(x, y) == Cell::NONE)
                 actions.push_back({x, y});
         }
     return actions;
 }
 
+bool State::is_legal(Action action) const {
+    return allow_cells_.get(action.x, action.y) != 0 
+        && cells_.get(action.x, action.y) == Cell::NONE;
+}
+
 Cell State::operator() (int x, int y) const {
-    return cells_(x, y);
+    return cells_.get(x, y);
 }
 
-float get_sum_lines_hvalue_at(
-        const InfiniteMatrix<Cell>& cells, 
-        Action action, Cell current_player);
+LineScores get_sum_lines_hvalues_at(const InfiniteMatrix<Cell>& cells, Action action);
+
+// splitmix64 of the cell and its owner
+static std::uint64_t stone_key(Action action, Cell player) {
+    auto value = std::uint64_t(std::uint32_t(action.x)) << 32 
+        ^ std::uint64_t(std::uint32_t(action.y)) << 1 ^ (player == Cell::AI);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// the cells a stone makes legal
+static Frame allowed_by(Action action) {
+    const int size = allow_distance * 2 + 1;
+    return {action.x - allow_distance, action.y - allow_distance, size, size};
+}
 
-bool terminated_check(float new_ai_hvalue, float new_human_hvalue) {
-    const auto infinity = std::numeric_limits<float>::infinity();
-    return new_ai_hvalue == infinity || new_human_hvalue == infinity;
+std::uint64_t State::hash() const {
+    return current_player_ == Cell::AI ? ~hash_ : hash_;
 }
 
 void State::move(Action action) {
-    move_stack_.push(action);
+    move_stack_.push_back(action);
+    threat_marks_.push_back(threat_log_.size());
+    hash_ ^= stone_key(action, current_player_);
 
     auto& cell = cells_(action.x, action.y);
     cell = Cell::NONE;
 
-    float old_ai_hvalue = get_sum_lines_hvalue_at(cells_, action, Cell::AI);
-    float old_human_hvalue = get_sum_lines_hvalue_at(cells_, action, Cell::HUMAN);
+    auto old_hvalues = get_sum_lines_hvalues_at(cells_, action);
 
     cell = current_player_;
     current_player_ = inverse_of(current_player_);
 
-    for (int dx = -allow_distance; dx <= allow_distance; dx++)
-        for (int dy = -allow_distance; dy <= allow_distance; dy++)
-            allow_cells_(action.x + dx, action.y + dy)++;
+    // so that translated copies of a position have the same legal actions
+    if (move_stack_.size() == 1)
+        allow_cells_(0, 0)--;
+    allow_cells_.transform(allowed_by(action), [](unsigned char& allow) { allow++; });
 
-    float new_ai_hvalue = get_sum_lines_hvalue_at(cells_, action, Cell::AI);
-    float new_human_hvalue = get_sum_lines_hvalue_at(cells_, action, Cell::HUMAN);
+    mark_threats(action);
 
-    auto terminated = terminated_check(new_ai_hvalue, new_human_hvalue);
-    terminated_stack_.push(terminated);
+    auto new_hvalues = get_sum_lines_hvalues_at(cells_, action);
 
-    float hvalue = hvalue_stack_.top();
-    hvalue += (new_ai_hvalue - old_ai_hvalue) - (new_human_hvalue - old_human_hvalue);
-    hvalue_stack_.push(hvalue);
+    auto terminated = wins(action, cell);
+    terminated_stack_.push_back(terminated);
+
+    if (terminated) {
+        auto win = win_at(move_stack_.size());
+        hvalue_stack_.push_back(cell == Cell::AI ? win : -win);
+        return;
+    }
+    auto hvalue = hvalue_stack_.back();
+    hvalue += (new_hvalues.ai - old_hvalues.ai) - (new_hvalues.human - old_hvalues.human);
+    hvalue_stack_.push_back(hvalue);
 }
 
 void State::unmove() {
-    auto action = move_stack_.top();
-    move_stack_.pop();
+    auto action = move_stack_.back();
+    move_stack_.pop_back();
 
     cells_(action.x, action.y) = Cell::NONE;
     current_player_ = inverse_of(current_player_);
+    hash_ ^= stone_key(action, current_player_);
 
-    for (int dx = -allow_distance; dx <= allow_distance; dx++)
-        for (int dy = -allow_distance; dy <= allow_distance; dy++)
-            allow_cells_(action.x + dx, action.y + dy)--;
+    allow_cells_.transform(allowed_by(action), [](unsigned char& allow) { allow--; });
+    if (move_stack_.empty())
+        allow_cells_(0, 0)++;
 
-    terminated_stack_.pop();
-    hvalue_stack_.pop();
-}
+    terminated_stack_.pop_back();
+    hvalue_stack_.pop_back();
 
-void get_vertical_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action) {
-    auto inused = cells.inused();
-    line.clear();
-    for (int x = inused.x, y = action.y; x < inused.w + inused.x; x++) {
-        line.push_back(cells(x, y));
+    auto mark = threat_marks_.back();
+    threat_marks_.pop_back();
+    while (threat_log_.size() > mark) {
+        auto& entry = threat_log_.back();
+        threats_(entry.first.x, entry.first.y) = entry.second;
+        threat_log_.pop_back();
     }
 }
 
-void get_horizontal_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action) {
-    auto inused = cells.inused();
-    line.clear();
-    for (int x = action.x, y = inused.y; y < inused.h + inused.y; y++) {
-        line.push_back(cells(x, y));
+static const Action directions[4] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+
+static int player_index(Cell player) {
+    return player == Cell::AI ? 0 : 1;
+}
+
+LineMasks threat_window_masks(
+        const InfiniteMatrix<Cell>& cells, Action action, Action direction)
+{
+    LineMasks masks;
+    for (int i = 0; i <= threat_radius * 2; i++) {
+        int d = i - threat_radius;
+        auto cell = cells.get(action.x + d * direction.x, action.y + d * direction.y);
+        masks.ai |= std::uint64_t(cell == Cell::AI) << i;
+        masks.human |= std::uint64_t(cell == Cell::HUMAN) << i;
     }
+    return masks;
 }
 
-void get_first_diagonal_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action) {
-    auto inused = cells.inused();
-    line.clear();
-    for (int d = -1; fall_inside(action.x + d, action.y + d, inused); d--) {
-        line.push_back(cells(action.x + d, action.y + d));
+bool is_five_at(const InfiniteMatrix<Cell>& cells, Action action, Cell player) {
+    for (auto direction: directions) {
+        auto masks = threat_window_masks(cells, action, direction);
+        auto center = std::uint64_t{1} << threat_radius;
+        bool five = player == Cell::AI 
+            ? is_five_through(masks.ai | center, masks.human, threat_radius)
+            : is_five_through(masks.human | center, masks.ai, threat_radius);
+        if (five)
+            return true;
     }
-    std::reverse(line.begin(), line.end());
-    for (int d = 0; fall_inside(action.x + d, action.y + d, inused); d++) {
-        line.push_back(cells(action.x + d, action.y + d));
+    return false;
+}
+
+bool State::wins(Action action, Cell player) const {
+    return is_five_at(cells_, action, player);
+}
+
+Score gain_of_masks(std::uint64_t player, std::uint64_t opponent) {
+    auto before = cached_score_of_masks(player, opponent);
+    if (before == win_score)
+        return 0;
+    auto center = std::uint64_t{1} << threat_radius;
+    auto after = cached_score_of_masks(player | center, opponent);
+    return after == win_score ? win_score : after - before;
+}
+
+// changes are logged so that unmove() can restore them
+void State::set_threat(Action action, Threat threat) const {
+    auto& entry = threats_(action.x, action.y);
+    if (!threat_marks_.empty())
+        threat_log_.push_back({action, entry});
+    entry = threat;
+}
+
+void State::mark_threats(Action action) {
+    for (int dx = -allow_distance; dx <= allow_distance; dx++)
+        for (int dy = -allow_distance; dy <= allow_distance; dy++) {
+            Action cell{action.x + dx, action.y + dy};
+            if (allow_cells_.get(cell.x, cell.y) != 1 
+                    || cells_.get(cell.x, cell.y) != Cell::NONE)
+                continue;
+
+            auto threat = threats_.get(cell.x, cell.y);
+            if (threat.dirty != 0xF) {
+                threat.dirty = 0xF;
+                set_threat(cell, threat);
+            }
+        }
+
+    for (int k = 0; k < 4; k++)
+        for (int d = -threat_radius; d <= threat_radius; d++) {
+            Action cell{action.x + d * directions[k].x, action.y + d * directions[k].y};
+            if (allow_cells_.get(cell.x, cell.y) == 0 
+                    || cells_.get(cell.x, cell.y) != Cell::NONE)
+                continue;
+
+            auto threat = threats_.get(cell.x, cell.y);
+            if (!(threat.dirty & (1 << k))) {
+                threat.dirty |= 1 << k;
+                set_threat(cell, threat);
+            }
+        }
+}
+
+Threat State::refreshed_threat(Action action) const {
+    auto threat = threats_.get(action.x, action.y);
+    if (threat.dirty == 0)
+        return threat;
+
+    for (int k = 0; k < 4; k++) {
+        if (!(threat.dirty & (1 << k)))
+            continue;
+        auto masks = threat_window_masks(cells_, action, directions[k]);
+        threat.gains[k][player_index(Cell::AI)] = gain_of_masks(masks.ai, masks.human);
+        threat.gains[k][player_index(Cell::HUMAN)] = gain_of_masks(masks.human, masks.ai);
+        auto center = std::uint64_t{1} << threat_radius;
+        threat.fives[k][player_index(Cell::AI)] = 
+            is_five_through(masks.ai | center, masks.human, threat_radius);
+        threat.fives[k][player_index(Cell::HUMAN)] = 
+            is_five_through(masks.human | center, masks.ai, threat_radius);
     }
+    threat.dirty = 0;
+    set_threat(action, threat);
+    return threat;
 }
 
-void get_second_diagonal_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action)  {
-    auto inused = cells.inused();
-    line.clear();
-    for (int d = -1; fall_inside(action.x + d, action.y - d, inused); d--) {
-        line.push_back(cells(action.x + d, action.y - d));
+Score State::gain(Action action, Cell player) const {
+    auto threat = refreshed_threat(action);
+    Score result = 0;
+    for (int k = 0; k < 4; k++)
+        result += threat.gains[k][player_index(player)];
+    return std::min(result, win_score);
+}
+
+std::vector<Action> State::ordered_actions(
+        size_t max_count, const SearchContext *context) const 
+{
+    struct ActionGain {
+        Action action;
+        Score gain;
+        unsigned int history;
+    };
+
+    std::vector<ActionGain> gains;
+    for (auto action: legal_actions()) {
+        auto sum = gain(action, current_player_) 
+            + gain(action, inverse_of(current_player_));
+        gains.push_back({action, sum, context ? context->history(action) : 0});
     }
-    std::reverse(line.begin(), line.end());
-    for (int d = 0; fall_inside(action.x + d, action.y - d, inused); d++) {
-        line.push_back(cells(action.x + d, action.y - d));
+
+    std::stable_sort(gains.begin(), gains.end(), 
+            [](ActionGain a, ActionGain b) { 
+                return a.gain > b.gain || (a.gain == b.gain && a.history > b.history); 
+    });
+
+    std::vector<Action> actions;
+    actions.reserve(std::min(max_count, gains.size()));
+    for (auto e: gains) {
+        if (actions.size() == max_count)
+            break;
+        actions.push_back(e.action);
+    }
+    return actions;
+}
+
+static bool makes_five(const Threat& threat, Cell player) {
+    for (int k = 0; k < 4; k++)
+        if (threat.fives[k][player_index(player)])
+            return true;
+    return false;
+}
+
+// read from the threat map, only the cells changed since the last call are rescanned
+std::vector<Action> State::forcing_actions() const {
+    std::vector<Action> winning, blocking;
+    auto inused = allow_cells_.inused();
+    for (int x = inused.x; x < inused.x + inused.w; x++)
+        for (int y = inused.y; y < inused.y + inused.h; y++) {
+            if (allow_cells_(x, y) == 0 || cells_.get(x, y) != Cell::NONE)
+                continue;
+            auto threat = refreshed_threat({x, y});
+            if (makes_five(threat, current_player_))
+                winning.push_back({x, y});
+            else if (winning.empty() && makes_five(threat, inverse_of(current_player_)))
+                blocking.push_back({x, y});
+        }
+    return winning.empty() ? blocking : winning;
+}
+
+static Score saturated_sum(Score total, Score score) {
+    return (total == win_score || score == win_score) ? win_score : total + score;
+}
+
+// both players' sums, every line is scanned once
+LineScores get_sum_lines_hvalues_at(const InfiniteMatrix<Cell>& cells, Action action) {
+    LineScores result;
+    for (auto direction: directions) {
+        auto line = cells.line(action.x, action.y, direction.x, direction.y);
+        auto scores = scores_of_line(line);
+        result.ai = saturated_sum(result.ai, scores.ai);
+        result.human = saturated_sum(result.human, scores.human);
     }
+    return result;
 }
 
-float get_sum_lines_hvalue_at(
+Score get_sum_lines_hvalue_at(
         const InfiniteMatrix<Cell>& cells, 
         Action action, Cell current_player)
 {
-    float result = 0.0f;
-    static Line line(100);
-
-    get_vertical_line(line, cells, action);
-    result += score_of_line(line, current_player);
-
-    get_horizontal_line(line, cells, action);
-    result += score_of_line(line, current_player);
+    auto scores = get_sum_lines_hvalues_at(cells, action);
+    return current_player == Cell::AI ? scores.ai : scores.human;
+}
 
-    get_first_diagonal_line(line, cells, action);
-    result += score_of_line(line, current_player);
+bool SearchControl::stopped() const {
+    if (stop && stop->load(std::memory_order_relaxed))
+        return true;
+    return deadline != std::chrono::steady_clock::time_point::max()
+        && std::chrono::steady_clock::now() >= deadline;
+}
 
-    get_second_diagonal_line(line, cells, action);
-    result += score_of_line(line, current_player);
+static void move_to_front(std::vector<Action>& actions, Action action) {
+    auto it = std::find(actions.begin(), actions.end(), action);
+    if (it != actions.end())
+        std::rotate(actions.begin(), it, it + 1);
+}
 
-    return result;
+// the move of the last principal variation first, then the context's best 
+// move of the position
+static std::vector<Action> search_order(const State& state, const SearchContext *context) {
+    auto actions = state.ordered_actions(SIZE_MAX, context);
+    if (!context)
+        return actions;
+    auto key = state.hash();
+    if (auto *entry = context->probe(key))
+        move_to_front(actions, entry->best);
+    Action principal;
+    if (context->principal_move(key, principal))
+        move_to_front(actions, principal);
+    return actions;
 }
 
-float alphabeta(State& state, unsigned int depth, float alpha, float beta) {
+// nodes visited by alphabeta() on the calling thread
+static thread_local std::uint64_t alphabeta_nodes = 0;
+
+Score alphabeta(State& state, unsigned int depth, Score alpha, Score beta, 
+        const SearchControl& control)
+{
+    alphabeta_nodes++;
     if (depth == 0 || state.is_terminal())
         return state.hvalue();
+
+    auto *context = control.context;
+    if (context) {
+        auto *entry = context->probe(state.hash());
+        if (entry && entry->depth >= depth
+                && (entry->bound == Bound::Exact
+                    || (entry->bound == Bound::Lower && entry->score >= beta)
+                    || (entry->bound == Bound::Upper && entry->score <= alpha)))
+            return entry->score;
+    }
+
+    auto actions = search_order(state, context);
+    Action best = actions[0];
+    const auto old_alpha = alpha, old_beta = beta;
     if (state.is_maximizing()) {
-        for (auto action: state.legal_actions()) {
+        for (auto action: actions) {
+            if (control.stopped())
+                break;
             state.move(action);
             auto move_guard = gsl::finally([&state]() { state.unmove(); });
 
-            float score = alphabeta(state, depth - 1, alpha, beta);
-            alpha = std::max(alpha, score);
+            auto score = alphabeta(state, depth - 1, alpha, beta, control);
+            if (score > alpha) {
+                alpha = score;
+                best = action;
+            }
 
-            if (beta <= alpha)
+            if (beta <= alpha) {
+                if (context)
+                    context->reward(action, depth);
                 break;
+            }
+        }
+        if (context && !control.stopped()) {
+            auto bound = alpha >= old_beta ? Bound::Lower 
+                : alpha <= old_alpha ? Bound::Upper : Bound::Exact;
+            context->store(state.hash(), alpha, depth, bound, best);
         }
         return alpha;
     }
     else {
-        for (auto action: state.legal_actions()) {
+        for (auto action: actions) {
+            if (control.stopped())
+                break;
             state.move(action);
             auto move_guard = gsl::finally([&state]() { state.unmove(); });
 
-            float score = alphabeta(state, depth - 1, alpha, beta);
-            beta = std::min(beta, score);
+            auto score = alphabeta(state, depth - 1, alpha, beta, control);
+            if (score < beta) {
+                beta = score;
+                best = action;
+            }
 
-            if (beta <= alpha)
+            if (beta <= alpha) {
+                if (context)
+                    context->reward(action, depth);
                 break;
+            }
+        }
+        if (context && !control.stopped()) {
+            auto bound = beta <= old_alpha ? Bound::Upper 
+                : beta >= old_beta ? Bound::Lower : Bound::Exact;
+            context->store(state.hash(), beta, depth, bound, best);
         }
         return beta;
     }
 }
 
-Action AI_next_move(State& state) {
+// the best moves stored from the state on and the keys of the positions 
+// they are played from, the state is left unchanged
+static std::vector<Action> principal_variation_of(State& state, const SearchContext& context, 
+        unsigned int max_length, std::vector<std::uint64_t>& keys) 
+{
+    std::vector<Action> actions;
+    keys.clear();
+    while (actions.size() < max_length && !state.is_terminal()) {
+        auto *entry = context.probe(state.hash());
+        if (!entry)
+            break;
+        auto legal = state.legal_actions();
+        if (std::find(legal.begin(), legal.end(), entry->best) == legal.end())
+            break;
+        actions.push_back(entry->best);
+        keys.push_back(state.hash());
+        state.move(entry->best);
+    }
+    for (size_t i = 0; i < actions.size(); i++)
+        state.unmove();
+    return actions;
+}
+
+Action AI_next_move(State& state, const SearchControl& control) {
     assert (state.current_player() == Cell::AI);
 
-    auto actions = state.legal_actions();
-    Action result = actions[0];
-    const auto infinity = std::numeric_limits<float>::infinity();
-    float prev_hvalue = -infinity;
-    for (auto action: state.legal_actions()) {
-        state.move(action);
-        auto move_guard = gsl::finally([&state]() { state.unmove(); });
-        float new_hvalue = alphabeta(state, alphabeta_depth, -infinity, infinity);
-
-        if (new_hvalue > prev_hvalue) {
-            result = action;
-            prev_hvalue = new_hvalue;
+    auto *context = control.context;
+    // after the expected reply the root is on the last principal variation,
+    // whose next move is tried first
+    auto actions = context ? search_order(state, context) : state.legal_actions();
+    auto fastest_win = win_at(state.moves().size() + 1);
+    if (context)
+        context->next_search();
+    SearchReport result;
+    result.best = actions[0];
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto start_nodes = alphabeta_nodes;
+    auto publish = [&](SearchReport& report) {
+        report.cache = eval_cache_stats();
+        report.nodes = alphabeta_nodes - start_nodes;
+        report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+        if (control.report)
+            control.report(report);
+    };
+
+    CanonicalKey key;
+    if (control.analysis) {
+        key = canonical_key_of(state);
+        AnalysisEntry entry;
+        bool complete = control.analysis->lookup(key.hash, entry)
+            && entry.bound == Bound::Exact
+            && (entry.depth > alphabeta_depth || is_win(entry.score));
+        auto best = key.transform.inverse(entry.best);
+        if (complete && std::find(actions.begin(), actions.end(), best) != actions.end()) {
+            result.best = best;
+            result.score = entry.score;
+            result.depth = entry.depth;
+            publish(result);
+            return best;
         }
-        if (prev_hvalue == infinity)
-            return result;
     }
-    return result;
+
+    // the iterations a former search already completed from this position,
+    // typically two plies down its principal variation
+    unsigned int first_depth = 0;
+    const TranspositionEntry *entry = context ? context->probe(state.hash()) : nullptr;
+    if (entry && entry->bound == Bound::Exact
+            && std::find(actions.begin(), actions.end(), entry->best) != actions.end()) {
+        result.best = entry->best;
+        result.score = entry->score;
+        result.depth = entry->depth;
+        publish(result);
+        first_depth = is_win(result.score) ? alphabeta_depth + 1 : entry->depth;
+    }
+
+    for (unsigned int depth = first_depth; depth <= alphabeta_depth; depth++) {
+        SearchReport iteration;
+        iteration.best = actions[0];
+        iteration.score = -win_score;
+        iteration.depth = depth + 1;
+        for (auto action: actions) {
+            if (control.stopped())
+                return result.best;
+            state.move(action);
+            auto move_guard = gsl::finally([&state]() { state.unmove(); });
+            auto new_hvalue = alphabeta(state, depth, -win_score, win_score, control);
+
+            // an interrupted subtree has no meaningful value
+            if (control.stopped())
+                return result.best;
+
+            if (new_hvalue > iteration.score) {
+                iteration.best = action;
+                iteration.score = new_hvalue;
+            }
+            if (iteration.score == fastest_win)
+                break;
+        }
+
+        result = iteration;
+        publish(result);
+        if (is_win(result.score))
+            break;
+    }
+
+    if (context) {
+        context->store(state.hash(), result.score, result.depth, Bound::Exact, result.best);
+        std::vector<std::uint64_t> keys;
+        auto variation = principal_variation_of(state, *context, result.depth, keys);
+        context->set_principal_variation(std::move(variation), std::move(keys));
+    }
+
+    if (control.analysis) {
+        AnalysisEntry entry;
+        entry.score = result.score;
+        entry.depth = result.depth;
+        entry.best = key.transform.apply(result.best);
+        control.analysis->store(key.hash, entry);
+    }
+    return result.best;
 }
 
 } // namespace gomoku
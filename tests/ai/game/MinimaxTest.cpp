@@ -53,6 +53,103 @@ TEST(Minimax, tictactoe) {
     ASSERT_EQ(utility, std::numeric_limits<float>::infinity());
 }
 
+TEST(Minimax, pruned_draw) {
+    using tictactoe::State;
+
+    State state{State::PLAYER_AI};
+    Minimax<State> solver{state};
+    solver.next_action();
+    ASSERT_EQ(solver.value(), 0.0f);
+    // the full game tree has 549946 nodes
+    ASSERT_LT(solver.nodes(), 549946 / 10);
+
+    state.move(tictactoe::Action(1, 1));
+    state.move(tictactoe::Action(2, 1));
+    Minimax<State> winning{state};
+    winning.next_action();
+    ASSERT_EQ(winning.value(), std::numeric_limits<float>::infinity());
+}
+
+// the same game without a StateHash specialization
+struct UnhashedState: tictactoe::State {
+    using tictactoe::State::State;
+};
+
+TEST(Minimax, transposition_table) {
+    using tictactoe::State;
+
+    static_assert(has_state_hash<State>::value, "");
+    static_assert(!has_state_hash<UnhashedState>::value, "");
+
+    State state{State::PLAYER_AI};
+    Minimax<State> solver{state};
+    auto next = solver.next_action();
+
+    UnhashedState unhashed{State::PLAYER_AI};
+    Minimax<UnhashedState> unhashed_solver{unhashed};
+    auto unhashed_next = unhashed_solver.next_action();
+
+    ASSERT_EQ(next.x(), unhashed_next.x());
+    ASSERT_EQ(next.y(), unhashed_next.y());
+    ASSERT_EQ(solver.value(), unhashed_solver.value());
+    ASSERT_LT(solver.nodes(), 5000);
+    ASSERT_LT(solver.nodes(), unhashed_solver.nodes() / 3);
+}
+
+TEST(Minimax, game_traits) {
+    using tictactoe::State;
+    using Traits = GameTraits<State>;
+    static_assert(std::is_same<Traits::Action, tictactoe::Action>::value, "");
+    static_assert(std::is_same<Traits::Value, float>::value, "");
+
+    State state{State::PLAYER_AI};
+    ASSERT_TRUE(Traits::ai_to_move(state));
+    std::vector<tictactoe::Action> actions;
+    Traits::actions(state, actions);
+    ASSERT_EQ(actions.size(), 9);
+
+    state.move(actions[4]);
+    Traits::unmove(state, actions[4]);
+    ASSERT_EQ(state(2, 2), State::NONE);
+    ASSERT_TRUE(Traits::same_action(actions[4], tictactoe::Action{2, 2}));
+
+    float utility;
+    ASSERT_FALSE(Traits::is_terminal(state, utility));
+}
+
+TEST(Minimax, table_replacement) {
+    TranspositionTable<tictactoe::Action> table{100};
+    ASSERT_EQ(table.size(), 64);
+    ASSERT_EQ(table.probe(3), nullptr);
+
+    table.store(3, 1.0f, 5, TableBound::Lower, tictactoe::Action{2, 2});
+    auto entry = table.probe(3);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(entry->value, 1.0f);
+    ASSERT_EQ(entry->bound, TableBound::Lower);
+    ASSERT_EQ(entry->best.x(), 2);
+
+    // a shallower search of another position keeps the deeper entry
+    table.store(3 + 64, 0.0f, 2, TableBound::Exact, tictactoe::Action{1, 1});
+    ASSERT_EQ(table.probe(3 + 64), nullptr);
+    table.store(3 + 64, 0.0f, 5, TableBound::Exact, tictactoe::Action{1, 1});
+    ASSERT_EQ(table.probe(3), nullptr);
+    ASSERT_NE(table.probe(3 + 64), nullptr);
+}
+
+TEST(Minimax, depth_limit) {
+    using tictactoe::State;
+
+    State state{State::PLAYER_AI};
+    auto center = [](const State& state) { return state(2, 2) == State::X ? 1.0f : 0.0f; };
+    Minimax<State> solver{state, 1, center};
+    auto next = solver.next_action();
+    ASSERT_EQ(next.x(), 2);
+    ASSERT_EQ(next.y(), 2);
+    ASSERT_EQ(solver.value(), 1.0f);
+    ASSERT_EQ(solver.nodes(), 10);
+}
+
 } // namespace game
 } // namespace ai
 
@@ -1,6 +1,9 @@
 #include <gmock/gmock.h>
 #include <ai/game/gomoku/AIMover.hpp>
 #include <chrono>
+#include <algorithm>
+#include <vector>
+#include "Played.hpp"
 
 namespace ai {
 namespace game {
@@ -8,21 +11,138 @@ namespace gomoku {
 
 using namespace std::chrono;
 
+// polls moved(), which clears the flag, false when the timeout expires first
+static bool wait_moved(AIMover& mover, steady_clock::duration timeout = 5s) {
+    auto deadline = steady_clock::now() + timeout;
+    while (!mover.moved()) {
+        if (steady_clock::now() >= deadline)
+            return false;
+        std::this_thread::sleep_for(100us);
+    }
+    return true;
+}
+
 TEST(AIMover, moved) {
     State state{Cell::AI};
-    AIMover mover{state};
-    mover.next_move_in_background();
-    ASSERT_EQ(mover.moved(), false);
+    AIMover mover;
+    mover.next_move_in_background(state);
     ASSERT_EQ(mover.thinking(), true);
 
-    std::this_thread::sleep_for(30ms);
+    ASSERT_TRUE(wait_moved(mover));
     ASSERT_EQ(mover.thinking(), false);
-    ASSERT_EQ(mover.moved(), true);
     auto recent = mover.recent_move();
     ASSERT_EQ(recent.x, 0);
     ASSERT_EQ(recent.y, 0);
 }
 
+TEST(AIMover, stop) {
+    auto state = played(Cell::HUMAN, opening);
+    AIMover mover;
+    std::vector<steady_clock::duration> latencies;
+    for (int i = 0; i < 9; i++) {
+        mover.next_move_in_background(state);
+        ASSERT_EQ(mover.thinking(), true);
+        // well inside the search of the deepest iteration
+        std::this_thread::sleep_for(20ms);
+
+        auto begin = steady_clock::now();
+        mover.stop();
+        latencies.push_back(steady_clock::now() - begin);
+
+        ASSERT_EQ(mover.thinking(), false);
+        ASSERT_EQ(mover.moved(), false);
+    }
+    ASSERT_EQ(state.current_player(), Cell::AI);
+
+    // the median, a whole iteration takes hundreds of milliseconds
+    std::sort(latencies.begin(), latencies.end());
+    ASSERT_LT(latencies[latencies.size() / 2], 5ms);
+}
+
+TEST(AIMover, deadline) {
+    auto state = played(Cell::HUMAN, opening);
+    AIMover mover{10ms};
+    mover.next_move_in_background(state);
+    ASSERT_TRUE(wait_moved(mover));
+    ASSERT_EQ(mover.thinking(), false);
+    auto actions = state.legal_actions();
+    ASSERT_NE(std::find(actions.begin(), actions.end(), mover.recent_move()), actions.end());
+}
+
+TEST(AIMover, reused_across_moves) {
+    State state{Cell::AI};
+    AIMover mover;
+    for (int i = 0; i < 3; i++) {
+        mover.next_move_in_background(state);
+        ASSERT_TRUE(wait_moved(mover));
+        state.move(mover.recent_move());
+        state.move(state.legal_actions().back());
+    }
+    ASSERT_EQ(state.current_player(), Cell::AI);
+}
+
+TEST(AIMover, on_moved) {
+    State state{Cell::AI};
+    AIMover mover;
+    std::mutex mutex;
+    std::condition_variable condition;
+    int calls = 0;
+    mover.on_moved([&]() {
+        std::lock_guard<std::mutex> guard{mutex};
+        calls++;
+        condition.notify_all();
+    });
+    mover.next_move_in_background(state);
+
+    std::unique_lock<std::mutex> lock{mutex};
+    ASSERT_TRUE(condition.wait_for(lock, 1s, [&]() { return calls > 0; }));
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(mover.moved(), true);
+}
+
+TEST(AIMover, destroyed_while_thinking) {
+    auto state = std::make_unique<State>(played(Cell::HUMAN, opening));
+    {
+        AIMover mover;
+        mover.next_move_in_background(*state);
+        state.reset();
+    }
+}
+
+TEST(AIMover, searches_a_copy) {
+    auto state = played(Cell::HUMAN, opening);
+    AIMover mover;
+    mover.next_move_in_background(state);
+    ASSERT_EQ(mover.thinking(), true);
+
+    // the board can be used while the AI thinks
+    auto actions = state.ordered_actions();
+    state.move(actions[0]);
+    state.unmove();
+    mover.stop();
+}
+
+TEST(AIMover, progress) {
+    auto state = played(Cell::HUMAN, opening);
+    AIMover mover;
+    SearchReport report;
+    ASSERT_FALSE(mover.progress(report));
+
+    mover.next_move_in_background(state);
+    while (!mover.progress(report) && mover.thinking())
+        std::this_thread::sleep_for(100us);
+
+    ASSERT_GE(report.depth, 1);
+    ASSERT_GT(report.cache.hits + report.cache.misses, 0);
+    auto actions = state.legal_actions();
+    ASSERT_NE(std::find(actions.begin(), actions.end(), report.best), actions.end());
+
+    mover.move_now();
+    ASSERT_TRUE(wait_moved(mover));
+    ASSERT_EQ(mover.thinking(), false);
+    ASSERT_FALSE(mover.progress(report));
+}
+
 } // namespace gomoku
 } // namespace game
 } // namespace ai
@@ -0,0 +1,125 @@
+#include <gmock/gmock.h>
+#include <ai/game/gomoku/AnalysisCache.hpp>
+#include <ai/game/gomoku/CanonicalKey.hpp>
+#include <cstdio>
+#include <fstream>
+#include "Played.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+static std::string temporary_path(const std::string& name) {
+    auto path = testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+static AnalysisEntry entry_of(Score score, unsigned char depth, Action best) {
+    AnalysisEntry entry;
+    entry.score = score;
+    entry.depth = depth;
+    entry.best = best;
+    return entry;
+}
+
+TEST(AnalysisCache, persistent) {
+    auto path = temporary_path("analysis_persistent.bin");
+    AnalysisEntry entry;
+    {
+        AnalysisCache cache{path, 64};
+        ASSERT_FALSE(cache.lookup(7, entry));
+        cache.store(7, entry_of(-12, 3, {-2, 5}));
+        ASSERT_TRUE(cache.lookup(7, entry));
+        ASSERT_EQ(entry.score, -12);
+    }
+    {
+        AnalysisCache cache{path, 1024};
+        ASSERT_TRUE(cache.lookup(7, entry));
+        ASSERT_EQ(entry.score, -12);
+        ASSERT_EQ(entry.depth, 3);
+        ASSERT_EQ(entry.bound, Bound::Exact);
+        ASSERT_EQ(entry.best, (Action{-2, 5}));
+        ASSERT_FALSE(cache.lookup(7 + 64, entry));
+
+        // the shallower result is dropped
+        cache.store(7, entry_of(100, 2, {0, 0}));
+        cache.store(9, entry_of(-win_at(40), 1, {1, 1}));
+        ASSERT_TRUE(cache.merge());
+        ASSERT_TRUE(cache.lookup(7, entry));
+        ASSERT_EQ(entry.score, -12);
+        ASSERT_TRUE(cache.lookup(9, entry));
+        ASSERT_EQ(entry.score, -win_at(40));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(AnalysisCache, shared_file) {
+    auto path = temporary_path("analysis_shared.bin");
+    AnalysisCache writer{path, 64};
+    writer.store(1, entry_of(5, 1, {0, 0}));
+    ASSERT_TRUE(writer.merge());
+
+    AnalysisCache reader{path, 64};
+    AnalysisEntry entry;
+    ASSERT_TRUE(reader.lookup(1, entry));
+    ASSERT_FALSE(reader.lookup(2, entry));
+
+    // the mapping of the reader sees later merges
+    writer.store(2, entry_of(6, 1, {0, 0}));
+    ASSERT_TRUE(writer.merge());
+    ASSERT_TRUE(reader.lookup(2, entry));
+    ASSERT_EQ(entry.score, 6);
+    std::remove(path.c_str());
+}
+
+TEST(AnalysisCache, invalid_file) {
+    auto path = temporary_path("analysis_invalid.bin");
+    {
+        std::ofstream file{path};
+        file << "not a cache";
+    }
+    AnalysisCache cache{path, 64};
+    AnalysisEntry entry;
+    ASSERT_FALSE(cache.lookup(1, entry));
+    cache.store(1, entry_of(5, 1, {0, 0}));
+    ASSERT_FALSE(cache.merge());
+    ASSERT_TRUE(cache.lookup(1, entry));
+    std::remove(path.c_str());
+}
+
+TEST(AnalysisCache, AI_next_move) {
+    auto path = temporary_path("analysis_search.bin");
+    Transform transform{3, {-7, 4}};
+    auto state = played(Cell::HUMAN, opening);
+    std::vector<Action> moves;
+    for (auto action: opening)
+        moves.push_back(transform.inverse(action));
+    auto moved = played(Cell::HUMAN, moves);
+
+    Action best;
+    {
+        AnalysisCache cache{path};
+        SearchControl control;
+        control.analysis = &cache;
+        best = AI_next_move(state, control);
+    }
+
+    AnalysisCache cache{path};
+    unsigned int reports = 0;
+    SearchControl control;
+    control.analysis = &cache;
+    control.report = [&reports](const SearchReport& report) {
+        ASSERT_EQ(report.depth, alphabeta_depth + 1);
+        reports++;
+    };
+    // the reflected and translated position hits the stored result
+    auto action = AI_next_move(moved, control);
+    ASSERT_EQ(reports, 1);
+    ASSERT_EQ(action, transform.inverse(best));
+    std::remove(path.c_str());
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
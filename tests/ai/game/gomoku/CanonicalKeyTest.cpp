@@ -0,0 +1,91 @@
+#include <gmock/gmock.h>
+#include <ai/game/gomoku/CanonicalKey.hpp>
+#include "Played.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+static const Action shape[] = {{0, 0}, {1, 1}, {1, 0}, {2, 0}, {0, 1}, {-1, -1}, {3, 0}};
+
+static State played_shape(Transform transform) {
+    std::vector<Action> moves;
+    for (auto action: shape)
+        moves.push_back(transform.inverse(action));
+    return played(Cell::HUMAN, moves);
+}
+
+TEST(CanonicalKey, transform) {
+    for (unsigned char symmetry = 0; symmetry < 8; symmetry++) {
+        Transform transform{symmetry, {7, -3}};
+        Action action{2, -5};
+        auto mapped = transform.apply(action);
+        ASSERT_EQ(transform.inverse(mapped), action);
+    }
+    Transform transform{1 | 2, {0, 0}};
+    ASSERT_EQ(transform.apply({2, 5}), (Action{-5, 2}));
+}
+
+TEST(CanonicalKey, translation) {
+    auto state = played_shape({});
+    auto translated = played_shape({0, {-20, 13}});
+    auto key = canonical_key_of(state, false);
+    auto compared = canonical_key_of(translated, false);
+    ASSERT_EQ(key.hash, compared.hash);
+
+    // a stored move maps back onto the translated board
+    Action best{4, 0};
+    auto canonical = key.transform.apply(best);
+    ASSERT_EQ(compared.transform.inverse(canonical), (Action{-16, 13}));
+
+    state.move({4, 0});
+    ASSERT_NE(canonical_key_of(state, false).hash, key.hash);
+}
+
+// only the stones decide the legal actions, the origin included
+TEST(CanonicalKey, translation_near_origin) {
+    auto state = played(Cell::HUMAN, {{3, 0}, {4, 1}});
+    ASSERT_FALSE(state.is_legal({0, 0}));
+
+    auto translated = played(Cell::HUMAN, {{0, 2}, {1, 3}});
+    ASSERT_EQ(canonical_key_of(translated).hash, canonical_key_of(state).hash);
+
+    auto actions = state.legal_actions();
+    auto compared = translated.legal_actions();
+    ASSERT_EQ(actions.size(), compared.size());
+    for (auto action: actions)
+        ASSERT_TRUE(translated.is_legal({action.x - 3, action.y + 2}));
+
+    state.unmove();
+    state.unmove();
+    ASSERT_TRUE(state.is_legal({0, 0}));
+    ASSERT_EQ(state.legal_actions().size(), 1);
+}
+
+TEST(CanonicalKey, symmetry) {
+    auto state = played_shape({});
+    auto key = canonical_key_of(state);
+    for (unsigned char symmetry = 1; symmetry < 8; symmetry++) {
+        Transform transform{symmetry, {5, -9}};
+        auto transformed = played_shape(transform);
+        auto compared = canonical_key_of(transformed);
+        ASSERT_EQ(compared.hash, key.hash);
+        ASSERT_NE(canonical_key_of(transformed, false).hash, 
+                canonical_key_of(state, false).hash);
+
+        Action best{4, 0};
+        auto moved = compared.transform.inverse(key.transform.apply(best));
+        ASSERT_EQ(moved, transform.inverse(best));
+    }
+}
+
+TEST(CanonicalKey, side_to_move) {
+    State human;
+    State ai{Cell::AI};
+    ASSERT_NE(canonical_key_of(human).hash, canonical_key_of(ai).hash);
+    ASSERT_EQ(canonical_key_of(human).transform.apply({1, 2}), (Action{1, 2}));
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
@@ -0,0 +1,76 @@
+#include <gmock/gmock.h>
+#include <ai/game/gomoku/EvalCache.hpp>
+#include <ai/game/gomoku/LineMask.hpp>
+#include <random>
+#include <thread>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+TEST(EvalCache, cached_score_of_masks) {
+    clear_eval_cache();
+    ASSERT_EQ(cached_score_of_masks(0b0110, 0b1000), score_of_masks(0b0110, 0b1000));
+    ASSERT_EQ(eval_cache_stats().misses, 1);
+    ASSERT_EQ(eval_cache_stats().hits, 0);
+
+    // the same pattern further along the line
+    ASSERT_EQ(cached_score_of_masks(0b0110 << 20, 0b1000 << 20), score_of_masks(0b0110, 0b1000));
+    ASSERT_EQ(eval_cache_stats().hits, 1);
+    ASSERT_FLOAT_EQ(eval_cache_stats().hit_rate(), 0.5);
+
+    ASSERT_EQ(cached_score_of_masks(0, 0b1000), 0);
+    ASSERT_EQ(eval_cache_stats().misses + eval_cache_stats().hits, 2);
+
+    reset_eval_cache_stats();
+    ASSERT_EQ(eval_cache_stats().hits, 0);
+}
+
+TEST(EvalCache, differential) {
+    std::mt19937_64 random{32};
+    std::uniform_int_distribution<int> percent{0, 99};
+    for (int i = 0; i < 20000; i++) {
+        std::uint64_t player = 0, opponent = 0;
+        for (int k = 0; k < 20; k++) {
+            int value = percent(random);
+            if (value < 30)
+                player |= std::uint64_t{1} << k;
+            else if (value < 50)
+                opponent |= std::uint64_t{1} << k;
+        }
+        ASSERT_EQ(cached_score_of_masks(player, opponent), score_of_masks(player, opponent));
+    }
+    ASSERT_GT(eval_cache_stats().hits, 0);
+}
+
+TEST(EvalCache, cached_scores_of_masks) {
+    clear_eval_cache();
+    auto scores = cached_scores_of_masks(0b0110, 0b1001);
+    ASSERT_EQ(scores.ai, score_of_masks(0b0110, 0b1001));
+    ASSERT_EQ(scores.human, score_of_masks(0b1001, 0b0110));
+    ASSERT_EQ(eval_cache_stats().misses, 1);
+
+    ASSERT_EQ(cached_score_of_masks(0b0110 << 3, 0b1001 << 3), scores.ai);
+    ASSERT_EQ(eval_cache_stats().hits, 1);
+
+    scores = cached_scores_of_masks(0, 0);
+    ASSERT_EQ(scores.ai, 0);
+    ASSERT_EQ(scores.human, 0);
+    ASSERT_EQ(eval_cache_stats().misses + eval_cache_stats().hits, 2);
+}
+
+TEST(EvalCache, per_thread_stats) {
+    clear_eval_cache();
+    cached_score_of_masks(0b111, 0);
+    std::thread thread{[]() {
+        ASSERT_EQ(eval_cache_stats().misses, 0);
+        cached_score_of_masks(0b111, 0);
+        ASSERT_EQ(eval_cache_stats().misses, 1);
+    }};
+    thread.join();
+    ASSERT_EQ(eval_cache_stats().misses, 1);
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
@@ -1,6 +1,5 @@
 #include <gmock/gmock.h>
-#include <ai/game/gomoku/State.hpp>
-#include <algorithm>
+#include <ai/game/gomoku/BoardGeometry.hpp>
 #include <cmath>
 
 namespace ai {
@@ -10,58 +9,77 @@ namespace gomoku {
 #define WIDTH 600
 #define HEIGHT 600
 #define CELL_SIZE 30
-#define MATRIX_SIZE 100
 
-typedef Action Position;
-
-struct Coord {
-    int x, y;
-};
+static BoardGeometry geometry(Coord slide={0, 0}) {
+    return {WIDTH, HEIGHT, CELL_SIZE, slide};
+}
 
-static Coord pos_to_coord(Position pos, Coord trans={0, 0}) {
-    Coord coord;
-    coord.x = WIDTH / 2 + pos.x * CELL_SIZE + trans.x;
-    coord.y = HEIGHT / 2 - CELL_SIZE 
-        - pos.y * CELL_SIZE + trans.y;
-    return coord;
+TEST(GUI, modulo) {
+    ASSERT_EQ(modulo(7, 30), 7);
+    ASSERT_EQ(modulo(30, 30), 0);
+    ASSERT_EQ(modulo(-1, 30), 29);
+    ASSERT_EQ(modulo(-60, 30), 0);
 }
 
-static Position coord_to_pos(Coord coord, Coord trans={0, 0}) {
-    Position pos;
-    pos.x = std::floor(float(coord.x - WIDTH / 2 - trans.x) 
-            / CELL_SIZE);
-    pos.y = std::floor(float(HEIGHT / 2 - 1 - coord.y + trans.y) 
-            / CELL_SIZE);
-    return pos;
+TEST(GUI, grid_origin) {
+    ASSERT_EQ(geometry().grid_origin().x, -CELL_SIZE);
+    ASSERT_EQ(geometry().grid_origin().y, -CELL_SIZE);
+
+    for (Coord slide: {Coord{0, 0}, Coord{45, -20}, Coord{-100000, 7777}}) {
+        auto grid = geometry(slide).grid_origin();
+        ASSERT_LT(grid.x, 0);
+        ASSERT_GE(grid.x, -CELL_SIZE);
+        ASSERT_LT(grid.y, 0);
+        ASSERT_GE(grid.y, -CELL_SIZE);
+
+        // cells of the grid line up with the cells of the board
+        auto cell = geometry(slide).pos_to_coord({-3, 5});
+        ASSERT_EQ(modulo(cell.x - grid.x, CELL_SIZE), 0);
+        ASSERT_EQ(modulo(cell.y - grid.y, CELL_SIZE), 0);
+    }
 }
 
 TEST(GUI, pos_to_coord) {
-    ASSERT_EQ(std::floor(-3.0 / 2), -2);
-    ASSERT_EQ(std::floor(float(29 - 300) / 30), -10);
+    auto coord = geometry().pos_to_coord({0, 0});
+    ASSERT_EQ(coord.x, 300);
+    ASSERT_EQ(coord.y, 270);
+
+    coord = geometry({45, -20}).pos_to_coord({-10, 9});
+    ASSERT_EQ(coord.x, 45);
+    ASSERT_EQ(coord.y, -20);
+
+    // the top left corner is in its own cell
+    for (Coord slide: {Coord{0, 0}, Coord{45, -20}, Coord{-100000, 7777}}) {
+        for (Position pos: {Position{0, 0}, Position{-3, 5}, Position{12, -7}}) {
+            auto back = geometry(slide).coord_to_pos(geometry(slide).pos_to_coord(pos));
+            ASSERT_EQ(back.x, pos.x);
+            ASSERT_EQ(back.y, pos.y);
+        }
+    }
 }
 
 TEST(GUI, coord_to_pos) {
-    auto pos = coord_to_pos({0, 0});
+    auto pos = geometry().coord_to_pos({0, 0});
     ASSERT_EQ(pos.x, -10);
     ASSERT_EQ(pos.y, 9);
 
-    pos = coord_to_pos({29, 29});
+    pos = geometry().coord_to_pos({29, 29});
     ASSERT_EQ(pos.x, -10);
     ASSERT_EQ(pos.y, 9);
 
-    pos = coord_to_pos({30, 29});
+    pos = geometry().coord_to_pos({30, 29});
     ASSERT_EQ(pos.x, -9);
     ASSERT_EQ(pos.y, 9);
 
-    pos = coord_to_pos({0, 0}, {30, 0});
+    pos = geometry({30, 0}).coord_to_pos({0, 0});
     ASSERT_EQ(pos.x, -11);
     ASSERT_EQ(pos.y, 9);
 
-    pos = coord_to_pos({0, 0}, {0, 60});
+    pos = geometry({0, 60}).coord_to_pos({0, 0});
     ASSERT_EQ(pos.x, -10);
     ASSERT_EQ(pos.y, 11);
 
-    pos = coord_to_pos({0, 0}, {0, 59});
+    pos = geometry({0, 59}).coord_to_pos({0, 0});
     ASSERT_EQ(pos.x, -10);
     ASSERT_EQ(pos.y, 11);
 }
@@ -13,48 +13,46 @@ TEST(Heuristic, get_segment_bitset) {
     ASSERT_EQ(sizeof(Cell), 1);
     size_t cell_count;
 
-    auto cells = get_segment_bitset({{X}, 0, 1}, X, cell_count);
+    auto cells = get_segment_bitset(LineView{{X}, 0, 1}, X, cell_count);
     ASSERT_EQ(cells, 0b1);
     ASSERT_EQ(cell_count, 1);
 
-    cells = get_segment_bitset({{X, X}, 0, 2}, X, cell_count);
+    cells = get_segment_bitset(LineView{{X, X}, 0, 2}, X, cell_count);
     ASSERT_EQ(cells, 0b11);
     ASSERT_EQ(cell_count, 2);
     
-    cells = get_segment_bitset({{X, N, X, X}, 0, 4}, X, cell_count);
+    cells = get_segment_bitset(LineView{{X, N, X, X}, 0, 4}, X, cell_count);
     ASSERT_EQ(cells, 0b1101);
     ASSERT_EQ(cell_count, 4);
 
-    cells = get_segment_bitset({{X, X, N, X, N, X}, 0, 6}, X, cell_count);
+    cells = get_segment_bitset(LineView{{X, X, N, X, N, X}, 0, 6}, X, cell_count);
     ASSERT_EQ(cells, 0b1011);
     ASSERT_EQ(cell_count, 6);
 
-    cells = get_segment_bitset({{X, X, N, X, N, X}, 1, 4}, X, cell_count);
+    cells = get_segment_bitset(LineView{{X, X, N, X, N, X}, 1, 4}, X, cell_count);
     ASSERT_EQ(cells, 0b101);
     ASSERT_EQ(cell_count, 3);
 
-    cells = get_segment_bitset({{O, O, N, O, N, O}, 1, 4}, O, cell_count);
+    cells = get_segment_bitset(LineView{{O, O, N, O, N, O}, 1, 4}, O, cell_count);
     ASSERT_EQ(cells, 0b101);
     ASSERT_EQ(cell_count, 3);
 
-    cells = get_segment_bitset({{O, O, N, O, N, O}, 1, 6}, O, cell_count);
+    cells = get_segment_bitset(LineView{{O, O, N, O, N, O}, 1, 6}, O, cell_count);
     ASSERT_EQ(cells, 0b10101);
     ASSERT_EQ(cell_count, 5);
 
-    cells = get_segment_bitset({{O, O, O, O, O, O}, 0, 6}, O, cell_count);
+    cells = get_segment_bitset(LineView{{O, O, O, O, O, O}, 0, 6}, O, cell_count);
     ASSERT_EQ(cells, 0b11111);
     ASSERT_EQ(cell_count, 6);
 
-    cells = get_segment_bitset({{X, O, O, O, O, O, X}, 1, 6}, O, cell_count);
+    cells = get_segment_bitset(LineView{{X, O, O, O, O, O, X}, 1, 6}, O, cell_count);
     ASSERT_EQ(cells, 0b11111);
     ASSERT_EQ(cell_count, 5);
 }
 
-LineView maximum_view(LineView line_view, size_t size);
-
 TEST(Heuristic, maximum_view) {
     Line line{O, N, O, O, O, O, N};
-    auto view = maximum_view({line, 0, 7}, 4);
+    auto view = maximum_view(LineView{line, 0, 7}, 4);
     ASSERT_EQ(view.begin() - line.begin(), 2);
     ASSERT_EQ(view.end() - line.begin(), 6);
 }
@@ -107,8 +105,6 @@ TEST(Heuristic, cell_inverse_of) {
     ASSERT_EQ(inverse_of(Cell::NONE), Cell::NONE);
 }
 
-SegmentInfo::Distance left_distance_of(Line::const_iterator it, Line::const_iterator begin);
-
 TEST(Heuristic, left_distance_of) {
     Line line1{X, X, X};
     ASSERT_EQ(left_distance_of(line1.begin(), line1.begin()), SegmentInfo::Infinity);
@@ -124,8 +120,6 @@ TEST(Heuristic, left_distance_of) {
     ASSERT_EQ(left_distance_of(line6.begin() + 1, line6.begin()), SegmentInfo::Infinity);
 }
 
-SegmentInfo::Distance right_distance_of(Line::const_iterator it, Line::const_iterator end);
-
 TEST(Heuristic, right_distance_of) {
     Line line1{X, O};
     ASSERT_EQ(right_distance_of(line1.begin() + 1, line1.end()), SegmentInfo::Zero);
@@ -140,8 +134,6 @@ TEST(Heuristic, right_distance_of) {
     ASSERT_EQ(right_distance_of(line6.begin() + 1, line6.end()), SegmentInfo::Infinity);
 }
 
-Line::const_iterator reverse_search(Line::const_iterator it, Line::const_iterator begin, Cell value);
-
 TEST(Heuristic, reverse_search) {
     Line line1{X, X, N, O};
     auto it = reverse_search(line1.end(), line1.begin(), X);
@@ -161,39 +153,39 @@ TEST(Heuristic, segment_scoring_one) {
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_DOUBLE_EQ(score_of(segment), 1);
+    ASSERT_EQ(score_of(segment), 4);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0.75);
+    ASSERT_EQ(score_of(segment), 3);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0.75);
+    ASSERT_EQ(score_of(segment), 3);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0.5);
+    ASSERT_EQ(score_of(segment), 2);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0.5);
+    ASSERT_EQ(score_of(segment), 2);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0);
+    ASSERT_EQ(score_of(segment), 0);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0.25);
+    ASSERT_EQ(score_of(segment), 1);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0.25);
+    ASSERT_EQ(score_of(segment), 1);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_DOUBLE_EQ(score_of(segment), 0.5);
+    ASSERT_EQ(score_of(segment), 2);
 }
 
 TEST(Heuristic, segment_scoring_4) {
@@ -201,131 +193,127 @@ TEST(Heuristic, segment_scoring_4) {
     segment.cells = 0b1111;
     segment.cell_count = 4;
 
-    const auto nan = std::numeric_limits<float>::quiet_NaN();
-
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 128);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 96);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 96);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 64);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 64);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 0);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 32);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 32);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_NE(score_of(segment), nan);
+    ASSERT_EQ(score_of(segment), 64);
 }
 
 TEST(Heuristic, segment_scoring_5) {
     SegmentInfo segment;
-    const float infinity = std::numeric_limits<float>::infinity();
 
     segment.cells = 0b11111;
     segment.cell_count = 5;
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_FLOAT_EQ(score_of(segment), 0);
+    ASSERT_EQ(score_of(segment), 0);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 }
 
 TEST(Heuristic, segment_scoring_6) {
     SegmentInfo segment;
-    const float infinity = std::numeric_limits<float>::infinity();
 
     segment.cells = 0b11111;
     segment.cell_count = 6;
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Infinity;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Infinity;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::Zero;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::Zero;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 
     segment.distances[0] = SegmentInfo::One;
     segment.distances[1] = SegmentInfo::One;
-    ASSERT_FLOAT_EQ(score_of(segment), infinity);
+    ASSERT_EQ(score_of(segment), win_score);
 }
 
 } // namespace gomoku
@@ -140,6 +140,113 @@ TEST(InfiniteMatrix, inused) {
     assert_frame_eq(matrix.inused(), {1, 2, 1, 1});
 }
 
+TEST(InfiniteMatrix, compact_copy) {
+    InfiniteMatrix<int> matrix;
+    matrix(-3, 2) = 1;
+    matrix(4, 5) = 2;
+    matrix(40, -30) = 3;
+
+    auto copy = matrix.compact_copy(2);
+    assert_frame_eq(copy.inused(), matrix.inused());
+    assert_frame_eq(copy.frame(), {-5, -32, 48, 40});
+    ASSERT_EQ(copy.get(-3, 2), 1);
+    ASSERT_EQ(copy.get(4, 5), 2);
+    ASSERT_EQ(copy.get(40, -30), 3);
+    ASSERT_EQ(copy.get(0, 0), 0);
+    ASSERT_EQ(copy.get(100, 100), 0);
+
+    copy(60, 60) = 4;
+    ASSERT_EQ(copy(60, 60), 4);
+    ASSERT_EQ(copy(40, -30), 3);
+
+    InfiniteMatrix<int> empty;
+    ASSERT_EQ(empty.compact_copy(1).size(), 9);
+}
+
+TEST(InfiniteMatrix, region_add_and_fill) {
+    InfiniteMatrix<int> matrix;
+    matrix.add({-1, -1, 3, 3}, 2);
+    matrix.add({0, 0, 3, 3}, 1);
+    ASSERT_EQ(matrix(-1, -1), 2);
+    ASSERT_EQ(matrix(0, 0), 3);
+    ASSERT_EQ(matrix(2, 2), 1);
+    ASSERT_EQ(matrix.get(-2, -1), 0);
+    assert_frame_eq(matrix.inused(), {-1, -1, 4, 4});
+
+    matrix.fill({1, 1, 2, 1}, 7);
+    ASSERT_EQ(matrix(1, 1), 7);
+    ASSERT_EQ(matrix(2, 1), 7);
+    ASSERT_EQ(matrix(1, 2), 1);
+}
+
+TEST(InfiniteMatrix, region_grows_frame) {
+    InfiniteMatrix<int> matrix;
+    matrix(0, 0) = 5;
+    matrix.transform({20, -30, 10, 3}, [](int& value) { value = 1; });
+    ASSERT_EQ(matrix(0, 0), 5);
+    ASSERT_EQ(matrix(20, -30), 1);
+    ASSERT_EQ(matrix(29, -28), 1);
+    ASSERT_EQ(matrix.get(30, -28), 0);
+    assert_frame_eq(matrix.inused(), {0, -30, 30, 31});
+
+    int count = 0, sum = 0;
+    matrix.for_each({-5, -40, 100, 50}, [&](int x, int y, int value) {
+        count += value != 0;
+        sum += value;
+        ASSERT_TRUE(value != 5 || (x == 0 && y == 0));
+    });
+    ASSERT_EQ(count, 31);
+    ASSERT_EQ(sum, 35);
+
+    // beside the frame's rows, nothing to visit
+    auto frame = matrix.frame();
+    matrix.for_each({frame.x + frame.w + 10, frame.y, 5, frame.h}, 
+            [&](int, int, int) { count++; });
+    matrix.for_each({frame.x - 20, frame.y, 5, frame.h}, 
+            [&](int, int, int) { count++; });
+    ASSERT_EQ(count, 31);
+}
+
+TEST(InfiniteMatrix, region_for_each_outside_frame) {
+    InfiniteMatrix<int> matrix;
+    int count = 0;
+    matrix.for_each({100, 100, 5, 5}, [&](int, int, int) { count++; });
+    ASSERT_EQ(count, 0);
+    matrix.for_each({-30, 0, 10, 1}, [&](int x, int, int) {
+        ASSERT_GE(x, -25);
+        count++;
+    });
+    ASSERT_EQ(count, 5);
+}
+
+TEST(InfiniteMatrix, line) {
+    InfiniteMatrix<int> matrix;
+    for (int i = 0; i < 5; i++)
+        matrix(i - 2, 2 - i) = i + 1;
+    matrix(2, 2) = 9;
+
+    auto row = matrix.line(0, 0, 1, 0);
+    ASSERT_EQ(row.stride(), 1);
+    ASSERT_THAT(std::vector<int>(row.begin(), row.end()), testing::ElementsAre(0, 0, 3, 0, 0));
+
+    auto column = matrix.line(2, -1, 0, 1);
+    ASSERT_THAT(std::vector<int>(column.begin(), column.end()), testing::ElementsAre(5, 0, 0, 0, 9));
+
+    auto diagonal = matrix.line(0, 0, 1, 1);
+    ASSERT_THAT(std::vector<int>(diagonal.begin(), diagonal.end()), testing::ElementsAre(0, 0, 3, 0, 9));
+
+    auto anti_diagonal = matrix.line(1, -1, 1, -1);
+    ASSERT_EQ(anti_diagonal.size(), 5);
+    ASSERT_EQ(anti_diagonal[0], 1);
+    ASSERT_EQ(anti_diagonal.end() - anti_diagonal.begin(), 5);
+    ASSERT_THAT(std::vector<int>(
+                std::make_reverse_iterator(anti_diagonal.end()),
+                std::make_reverse_iterator(anti_diagonal.begin())), testing::ElementsAre(5, 4, 3, 2, 1));
+
+    ASSERT_TRUE(matrix.line(0, 10, 1, 0).empty());
+    ASSERT_EQ(matrix.line(-2, 1, 1, 1).size(), 2);
+}
+
 } // namespace gomoku
 } // namespace game
 } // namespace ai
@@ -0,0 +1,122 @@
+#include <gmock/gmock.h>
+#include <ai/game/gomoku/LineMask.hpp>
+#include <ai/game/gomoku/Heuristic.hpp>
+#include <random>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+const auto X = Cell::AI;
+const auto N = Cell::NONE;
+const auto O = Cell::HUMAN;
+
+static Line random_line(std::mt19937& random, int size) {
+    std::uniform_int_distribution<int> density{1, 9};
+    std::uniform_int_distribution<int> percent{0, 99};
+    int ai = density(random) * 5;
+    int human = density(random) * 5;
+
+    Line line;
+    for (int i = 0; i < size; i++) {
+        int value = percent(random);
+        if (value < ai)
+            line.push_back(X);
+        else if (value < ai + human)
+            line.push_back(O);
+        else
+            line.push_back(N);
+    }
+    return line;
+}
+
+TEST(LineMask, line_masks_of) {
+    Line line{X, N, O, X, X, N, N, O};
+    auto masks = line_masks_of(line.data(), line.size());
+    ASSERT_EQ(masks.ai, 0b00011001);
+    ASSERT_EQ(masks.human, 0b10000100);
+
+    std::mt19937 random{26};
+    for (int size = 0; size <= MAX_LINE_MASK_SIZE; size++) {
+        auto line = random_line(random, size);
+        auto masks = line_masks_of(line.data(), line.size());
+        auto compared = line_masks_scalar(line.data(), line.size());
+        ASSERT_EQ(masks.ai, compared.ai);
+        ASSERT_EQ(masks.human, compared.human);
+    }
+}
+
+TEST(LineMask, strided_line_masks_of) {
+    std::mt19937 random{39};
+    for (int stride: {1, 3, -2}) {
+        auto cells = random_line(random, MAX_LINE_MASK_SIZE * 3);
+        const Cell *first = stride > 0 ? cells.data() : cells.data() + cells.size() - 1;
+        StridedView<Cell> view{first, stride, MAX_LINE_MASK_SIZE};
+        Line line(view.begin(), view.end());
+        auto masks = line_masks_of(view);
+        auto compared = line_masks_scalar(line.data(), line.size());
+        ASSERT_EQ(masks.ai, compared.ai);
+        ASSERT_EQ(masks.human, compared.human);
+        ASSERT_EQ(score_of_line(view, X), segment_score_of_line(line, X));
+        ASSERT_EQ(segment_score_of_line(view, O), segment_score_of_line(line, O));
+    }
+}
+
+TEST(LineMask, score_of_masks) {
+    Line line{X, X, O, N, X, N, X, X};
+    auto masks = line_masks_of(line.data(), line.size());
+    ASSERT_EQ(score_of_masks(masks.ai, masks.human),
+            segment_score_of_line(line, X));
+    ASSERT_EQ(score_of_masks(masks.human, masks.ai),
+            segment_score_of_line(line, O));
+
+    Line five{N, X, X, X, X, X, N};
+    masks = line_masks_of(five.data(), five.size());
+    ASSERT_EQ(score_of_masks(masks.ai, masks.human), win_score);
+
+    Line blocked_five{O, X, X, X, X, X, O};
+    masks = line_masks_of(blocked_five.data(), blocked_five.size());
+    ASSERT_EQ(score_of_masks(masks.ai, masks.human), 0);
+}
+
+TEST(LineMask, scores_of_masks) {
+    std::mt19937 random{40};
+    std::uniform_int_distribution<int> sizes{1, MAX_LINE_MASK_SIZE};
+    for (int i = 0; i < 20000; i++) {
+        auto line = random_line(random, sizes(random));
+        auto masks = line_masks_of(line);
+        auto scores = scores_of_masks(masks.ai, masks.human);
+        ASSERT_EQ(scores.ai, score_of_masks(masks.ai, masks.human));
+        ASSERT_EQ(scores.human, score_of_masks(masks.human, masks.ai));
+
+        auto lines = scores_of_line(line);
+        ASSERT_EQ(lines.ai, scores.ai);
+        ASSERT_EQ(lines.human, scores.human);
+    }
+}
+
+TEST(LineMask, is_five_through) {
+    ASSERT_TRUE(is_five_through(0b0111110, 0, 3));
+    ASSERT_FALSE(is_five_through(0b0111110, 0, 0));
+    ASSERT_FALSE(is_five_through(0b0111100, 0, 3));
+    ASSERT_FALSE(is_five_through(0b0111110, 0b1000001, 3));
+    ASSERT_TRUE(is_five_through(0b0111110, 0b1000000, 5));
+    ASSERT_TRUE(is_five_through(0b1111110, 0b10000001, 1));
+    ASSERT_TRUE(is_five_through(0b11111, 0, 0));
+    ASSERT_TRUE(is_five_through(~std::uint64_t{0}, 0, 63));
+    ASSERT_FALSE(is_five_through(0b11110111, 0, 2));
+}
+
+TEST(LineMask, score_of_line_differential) {
+    std::mt19937 random{2017};
+    std::uniform_int_distribution<int> sizes{1, MAX_LINE_MASK_SIZE + 8};
+    for (int i = 0; i < 20000; i++) {
+        auto line = random_line(random, sizes(random));
+        ASSERT_EQ(score_of_line(line, X), segment_score_of_line(line, X));
+        ASSERT_EQ(score_of_line(line, O), segment_score_of_line(line, O));
+    }
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
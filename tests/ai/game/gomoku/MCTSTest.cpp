@@ -0,0 +1,92 @@
+#include <gmock/gmock.h>
+#include <ai/game/gomoku/MCTS.hpp>
+#include <algorithm>
+#include "Played.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+using namespace std::chrono;
+
+TEST(MCTS, immediate_win) {
+    // AI has four in a row, HUMAN has an open three
+    auto state = played(Cell::AI, {
+        {0, 0}, {0, 1}, {1, 0}, {1, 1}, {2, 0}, {2, 1}, {3, 0}, {5, 5}
+    });
+    MCTSOptions options;
+    options.max_playouts = 200;
+    auto action = MCTS_next_move(state, {}, options);
+    ASSERT_TRUE(action == Action({4, 0}) || action == Action({-1, 0}));
+}
+
+TEST(MCTS, block) {
+    // HUMAN threatens five on either end
+    auto state = played(Cell::HUMAN, {
+        {0, 0}, {0, 5}, {1, 0}, {5, 5}, {2, 0}, {-3, 3}, {3, 0}
+    });
+    ASSERT_EQ(state.current_player(), Cell::AI);
+    MCTSOptions options;
+    options.max_playouts = 200;
+    auto action = MCTS_next_move(state, {}, options);
+    ASSERT_TRUE(action == Action({4, 0}) || action == Action({-1, 0}));
+}
+
+TEST(MCTS, threads) {
+    auto state = played(Cell::HUMAN, opening);
+    auto moves = state.moves();
+
+    MCTSOptions options;
+    options.threads = 4;
+    options.max_playouts = 500;
+    SearchReport report;
+    SearchControl control;
+    control.report = [&report](const SearchReport& r) { report = r; };
+    auto action = MCTS_next_move(state, control, options);
+
+    auto actions = state.legal_actions();
+    ASSERT_NE(std::find(actions.begin(), actions.end(), action), actions.end());
+    ASSERT_EQ(report.best, action);
+    ASSERT_GE(report.depth, 2);
+    ASSERT_EQ(report.nodes, 500);
+    ASSERT_EQ(state.moves(), moves);
+}
+
+TEST(MCTS, deadline) {
+    auto state = played(Cell::HUMAN, opening);
+    MCTSOptions options;
+    options.threads = 2;
+    options.max_playouts = ~0u;
+    SearchControl control;
+    control.deadline = steady_clock::now() + 20ms;
+
+    auto begin = steady_clock::now();
+    MCTS_next_move(state, control, options);
+    ASSERT_LT(steady_clock::now() - begin, 200ms);
+}
+
+TEST(MCTS, full_arena) {
+    auto state = played(Cell::HUMAN, {{0, 0}, {1, 1}, {2, 2}});
+    MCTSOptions options;
+    options.threads = 2;
+    options.max_nodes = 64;
+    options.max_playouts = 500;
+    auto action = MCTS_next_move(state, {}, options);
+    auto actions = state.legal_actions();
+    ASSERT_NE(std::find(actions.begin(), actions.end(), action), actions.end());
+}
+
+TEST(MCTS, arena_smaller_than_branching) {
+    auto state = played(Cell::HUMAN, {{0, 0}, {1, 1}, {2, 2}});
+    MCTSOptions options;
+    options.threads = 2;
+    options.branching = 12;
+    options.max_nodes = 4;
+    options.max_playouts = 100;
+    auto action = MCTS_next_move(state, {}, options);
+    ASSERT_EQ(action, state.ordered_actions(1)[0]);
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
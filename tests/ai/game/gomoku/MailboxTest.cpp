@@ -0,0 +1,54 @@
+#include <gmock/gmock.h>
+#include <ai/game/gomoku/Mailbox.hpp>
+#include <thread>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+TEST(Mailbox, read_latest) {
+    Mailbox<int> mailbox;
+    int value = 0;
+    ASSERT_FALSE(mailbox.read(value));
+
+    mailbox.publish(1);
+    mailbox.publish(2);
+    ASSERT_TRUE(mailbox.read(value));
+    ASSERT_EQ(value, 2);
+
+    // kept until something newer arrives
+    ASSERT_TRUE(mailbox.read(value));
+    ASSERT_EQ(value, 2);
+
+    mailbox.publish(3);
+    ASSERT_TRUE(mailbox.read(value));
+    ASSERT_EQ(value, 3);
+}
+
+TEST(Mailbox, threads) {
+    struct Pair {
+        int a, b;
+    };
+
+    Mailbox<Pair> mailbox;
+    const int count = 100000;
+    std::thread writer([&mailbox]() {
+        for (int i = 1; i <= count; i++)
+            mailbox.publish({i, -i});
+    });
+
+    Pair pair{0, 0};
+    int last = 0;
+    while (last != count) {
+        if (mailbox.read(pair)) {
+            ASSERT_EQ(pair.a, -pair.b);
+            ASSERT_GE(pair.a, last);
+            last = pair.a;
+        }
+    }
+    writer.join();
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
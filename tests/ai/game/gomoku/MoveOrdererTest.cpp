@@ -24,8 +24,8 @@ TEST(MoveOrderer, actions_stored) {
     MoveOrderer orderer;
     // ASSERT_FALSE(orderer.actions_stored());
 
-    orderer.add_action({2, -3}, 20.0f);
-    orderer.add_action({3, -1}, 10.0f);
+    orderer.add_action({2, -3}, 20);
+    orderer.add_action({3, -1}, 10);
     // ASSERT_TRUE(orderer.actions_stored());
 
     auto actions = orderer.sorted_legal_actions();
@@ -0,0 +1,29 @@
+#ifndef TESTS_AI_GAME_GOMOKU_PLAYED_HPP
+#define TESTS_AI_GAME_GOMOKU_PLAYED_HPP
+
+#include <vector>
+#include <ai/game/gomoku/State.hpp>
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+// an opening that takes the search a while at alphabeta_depth,
+// the AI is to move after it when HUMAN starts
+static const std::vector<Action> opening = {
+    {0, 0}, {1, 1}, {1, 0}, {2, 0}, {0, 1}, 
+    {-1, -1}, {0, -1}, {2, 2}, {3, 3}
+};
+
+inline State played(Cell start_player, const std::vector<Action>& moves) {
+    State state{start_player};
+    for (auto action: moves)
+        state.move(action);
+    return state;
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
+
+#endif // TESTS_AI_GAME_GOMOKU_PLAYED_HPP
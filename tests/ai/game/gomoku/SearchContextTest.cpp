@@ -0,0 +1,118 @@
+#include <gmock/gmock.h>
+#include <ai/game/gomoku/SearchContext.hpp>
+#include "Played.hpp"
+
+namespace ai {
+namespace game {
+namespace gomoku {
+
+TEST(SearchContext, store) {
+    SearchContext context{1000};
+    ASSERT_EQ(context.probe(5), nullptr);
+
+    context.store(5, 12, 2, Bound::Lower, {1, -1});
+    auto *entry = context.probe(5);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(entry->score, 12);
+    ASSERT_EQ(entry->depth, 2);
+    ASSERT_EQ(entry->bound, Bound::Lower);
+    ASSERT_EQ(entry->best, (Action{1, -1}));
+
+    // 512 slots, 5 + 512 collides
+    context.store(5 + 512, 7, 1, Bound::Exact, {0, 0});
+    ASSERT_NE(context.probe(5), nullptr);
+    ASSERT_EQ(context.probe(5 + 512), nullptr);
+
+    context.next_search();
+    context.store(5 + 512, 7, 1, Bound::Exact, {0, 0});
+    ASSERT_EQ(context.probe(5), nullptr);
+    ASSERT_EQ(context.probe(5 + 512)->score, 7);
+
+    context.clear();
+    ASSERT_EQ(context.probe(5 + 512), nullptr);
+}
+
+TEST(SearchContext, history) {
+    SearchContext context;
+    context.reward({1, 2}, 2);
+    context.reward({1, 2}, 1);
+    ASSERT_EQ(context.history({1, 2}), 5);
+    ASSERT_EQ(context.history({2, 1}), 0);
+}
+
+TEST(SearchContext, hash) {
+    auto state = played(Cell::HUMAN, {{0, 0}, {1, 1}, {1, 0}});
+    auto transposed = played(Cell::HUMAN, {{1, 0}, {1, 1}, {0, 0}});
+    ASSERT_EQ(state.hash(), transposed.hash());
+    ASSERT_EQ(state.clone().hash(), state.hash());
+
+    auto hash = state.hash();
+    state.move({2, 2});
+    ASSERT_NE(state.hash(), hash);
+    state.unmove();
+    ASSERT_EQ(state.hash(), hash);
+
+    ASSERT_NE(State{Cell::AI}.hash(), State{Cell::HUMAN}.hash());
+}
+
+TEST(SearchContext, AI_next_move) {
+    auto state = played(Cell::HUMAN, opening);
+    Score score = 0, cold_score = 0;
+    SearchControl cold;
+    cold.report = [&cold_score](const SearchReport& report) { cold_score = report.score; };
+    AI_next_move(state, cold);
+
+    SearchContext context;
+    SearchControl control;
+    control.context = &context;
+    control.report = [&score](const SearchReport& report) { score = report.score; };
+    auto action = AI_next_move(state, control);
+    ASSERT_EQ(score, cold_score);
+
+    auto& variation = context.principal_variation();
+    ASSERT_EQ(variation.size(), alphabeta_depth + 1);
+    ASSERT_EQ(variation[0], action);
+    Action reply;
+    ASSERT_TRUE(context.expected_reply(reply));
+    ASSERT_EQ(reply, variation[1]);
+
+    // the played line was searched already
+    state.move(action);
+    state.move(reply);
+    auto *entry = context.probe(state.hash());
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(entry->best, variation[2]);
+    auto next = AI_next_move(state, control);
+    auto actions = state.legal_actions();
+    ASSERT_NE(std::find(actions.begin(), actions.end(), next), actions.end());
+}
+
+TEST(SearchContext, next_turn) {
+    auto state = played(Cell::HUMAN, opening);
+    SearchContext context;
+    SearchControl control;
+    control.context = &context;
+    std::uint64_t nodes = 0;
+    control.report = [&nodes](const SearchReport& report) { nodes = report.nodes; };
+    auto action = AI_next_move(state, control);
+    Action reply;
+    ASSERT_TRUE(context.expected_reply(reply));
+    auto variation = context.principal_variation();
+
+    state.move(action);
+    state.move(reply);
+    Action principal;
+    ASSERT_TRUE(context.principal_move(state.hash(), principal));
+    ASSERT_EQ(principal, variation[2]);
+    AI_next_move(state, control);
+    auto warm_nodes = nodes;
+
+    SearchContext fresh;
+    control.context = &fresh;
+    AI_next_move(state, control);
+    ASSERT_LT(warm_nodes, nodes);
+}
+
+} // namespace gomoku
+} // namespace game
+} // namespace ai
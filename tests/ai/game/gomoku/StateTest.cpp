@@ -1,7 +1,10 @@
 #include <gmock/gmock.h>
 #include <ai/game/gomoku/State.hpp>
 #include <algorithm>
+#include <climits>
 #include <ai/game/gomoku/Heuristic.hpp>
+#include <ai/game/Minimax.hpp>
+#include "Played.hpp"
 
 namespace ai {
 namespace game {
@@ -85,74 +88,62 @@ const auto X = Cell::AI;
 const auto N = Cell::NONE;
 const auto O = Cell::HUMAN;
 
-void assert_line_eq(const Line& a, const Line& b) {
+template <typename Lines>
+void assert_line_eq(const Lines& a, const Line& b) {
     ASSERT_TRUE(std::equal(a.begin(), a.end(), b.begin(), b.end()));
 }
 
-void get_vertical_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action);
-
-TEST(State, get_vertical_line) {
+TEST(State, vertical_line) {
     InfiniteMatrix<Cell> cells;
     cells(0, 0) = X;
     cells(1, 0) = X;
     cells(3, 0) = X;
-    Line line;
-    get_vertical_line(line, cells, {0, 0});
+    auto line = cells.line(0, 0, 1, 0);
     assert_line_eq(line, {X, X, N, X});
 }
 
-void get_horizontal_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action);
-
-TEST(State, get_horizontal_line) {
+TEST(State, horizontal_line) {
     InfiniteMatrix<Cell> cells;
     cells(0, 0) = X;
     cells(0, 1) = X;
     cells(0, 4) = X;
-    Line line;
-    get_horizontal_line(line, cells, {0, 0});
+    auto line = cells.line(0, 0, 0, 1);
     ASSERT_EQ(line.size(), 5);
     assert_line_eq(line, {X, X, N, N, X});
 }
 
-void get_first_diagonal_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action);
-
-TEST(State, get_first_diagonal_line) {
+TEST(State, first_diagonal_line) {
     InfiniteMatrix<Cell> cells;
     cells(0, 0) = X;
     cells(1, 1) = X;
     cells(2, 2) = X;
-    Line line;
-    get_first_diagonal_line(line, cells, {1, 1});
+    auto line = cells.line(1, 1, 1, 1);
     ASSERT_EQ(line.size(), 3);
     assert_line_eq(line, {X, X, X});
 }
 
-TEST(State, get_first_diagonal_line2) {
+TEST(State, first_diagonal_line2) {
     InfiniteMatrix<Cell> cells;
     cells(0, 0) = X;
     cells(-1, 1) = X;
     cells(-3, 3) = X;
 
-    Line line;
-    get_first_diagonal_line(line, cells, {-1, 1});
+    auto line = cells.line(-1, 1, 1, 1);
     ASSERT_EQ(line.size(), 3);
     assert_line_eq(line, {N, X, N});
 }
 
-void get_second_diagonal_line(Line& line, const InfiniteMatrix<Cell>& cells, Action action);
-
-TEST(State, get_second_diagonal_line) {
+TEST(State, second_diagonal_line) {
     InfiniteMatrix<Cell> cells;
     cells(0, 0) = X;
     cells(-1, 1) = X;
     cells(-3, 3) = X;
-    Line line;
-    get_second_diagonal_line(line, cells, {0, 0});
+    auto line = cells.line(0, 0, 1, -1);
     ASSERT_EQ(line.size(), 4);
     assert_line_eq(line, {X, N, X, X});
 }
 
-float get_sum_lines_hvalue_at(
+Score get_sum_lines_hvalue_at(
         const InfiniteMatrix<Cell>& cells_, 
         Action action, Cell current_player);
 
@@ -165,8 +156,8 @@ TEST(State, get_sum_lines_hvalue_at_vertical) {
     auto dh = get_sum_lines_hvalue_at(cells, {0, 0}, X);
     Line line1{X};
     Line line2{X, X, N, X};
-    float compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
-    ASSERT_DOUBLE_EQ(dh, compared);
+    auto compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
+    ASSERT_EQ(dh, compared);
 }
 
 TEST(State, get_sum_lines_hvalue_at_horizontal) {
@@ -178,8 +169,8 @@ TEST(State, get_sum_lines_hvalue_at_horizontal) {
     auto dh = get_sum_lines_hvalue_at(cells, {0, 0}, X);
     Line line1{X};
     Line line2{X, X, X};
-    float compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
-    ASSERT_DOUBLE_EQ(dh, compared);
+    auto compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
+    ASSERT_EQ(dh, compared);
 }
 
 TEST(State, get_sum_lines_hvalue_at_first_diagonal) {
@@ -192,8 +183,8 @@ TEST(State, get_sum_lines_hvalue_at_first_diagonal) {
     Line line1{X};
     Line line2{X, X, X};
 
-    float compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
-    ASSERT_DOUBLE_EQ(dh, compared);
+    auto compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
+    ASSERT_EQ(dh, compared);
 }
 
 TEST(State, get_sum_lines_hvalue_at_second_diagonal) {
@@ -206,44 +197,63 @@ TEST(State, get_sum_lines_hvalue_at_second_diagonal) {
     Line line1{X};
     Line line2{X, N, X, X};
 
-    float compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
-    ASSERT_DOUBLE_EQ(dh, compared);
+    auto compared = 3 * score_of_line(line1, X) + score_of_line(line2, X);
+    ASSERT_EQ(dh, compared);
 }
 
 TEST(State, hvalue) {
     State state;
     state.move({0, 0});
-    ASSERT_DOUBLE_EQ(state.hvalue(), -4);
+    ASSERT_EQ(state.hvalue(), -16);
     state.move({1, 0});
-    ASSERT_DOUBLE_EQ(state.hvalue(), 0);
+    ASSERT_EQ(state.hvalue(), 0);
     state.unmove();
-    ASSERT_DOUBLE_EQ(state.hvalue(), -4);
+    ASSERT_EQ(state.hvalue(), -16);
 }
 
 TEST(State, hvalue2) {
     InfiniteMatrix<Cell> cells;
-    ASSERT_DOUBLE_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, X), 0.0f);
-    ASSERT_DOUBLE_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, O), 0.0f);
+    ASSERT_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, X), 0);
+    ASSERT_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, O), 0);
     cells(0, 0) = O;
-    ASSERT_DOUBLE_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, X), 0.0f);
-    ASSERT_DOUBLE_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, O), 4.0f);
+    ASSERT_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, X), 0);
+    ASSERT_EQ(get_sum_lines_hvalue_at(cells, {0, 0}, O), 16);
     cells(-1, -1) = X;
-    ASSERT_DOUBLE_EQ(get_sum_lines_hvalue_at(cells, {-1, -1}, X), 3.5f);
-    ASSERT_DOUBLE_EQ(get_sum_lines_hvalue_at(cells, {-1, -1}, O), 0.5f);
+    ASSERT_EQ(get_sum_lines_hvalue_at(cells, {-1, -1}, X), 14);
+    ASSERT_EQ(get_sum_lines_hvalue_at(cells, {-1, -1}, O), 2);
     State state;
     state.move({0, 0});
-    ASSERT_DOUBLE_EQ(state.hvalue(), -4);
+    ASSERT_EQ(state.hvalue(), -16);
     state.move({-1, 1});
-    ASSERT_DOUBLE_EQ(state.hvalue(), 0);
+    ASSERT_EQ(state.hvalue(), 0);
 }
 
-bool terminated_check(float new_ai_hvalue, float new_human_hvalue);
+bool is_five_at(const InfiniteMatrix<Cell>& cells, Action action, Cell player);
 
-TEST(State, terminated_check) {
-    const auto infinity = std::numeric_limits<float>::infinity();
-    ASSERT_TRUE(terminated_check(infinity, 10));
-    ASSERT_TRUE(terminated_check(100, infinity));
-    ASSERT_FALSE(terminated_check(10, 10));
+TEST(State, is_five_at) {
+    InfiniteMatrix<Cell> cells;
+    for (int i = 0; i < 4; i++)
+        cells(i, i) = X;
+    ASSERT_TRUE(is_five_at(cells, {4, 4}, X));
+    ASSERT_TRUE(is_five_at(cells, {-1, -1}, X));
+    ASSERT_FALSE(is_five_at(cells, {5, 5}, X));
+    ASSERT_FALSE(is_five_at(cells, {4, 4}, O));
+
+    // an exact five blocked at both ends is no win, a longer run is
+    cells(-1, -1) = O;
+    cells(5, 5) = O;
+    ASSERT_FALSE(is_five_at(cells, {4, 4}, X));
+    cells(5, 5) = X;
+    cells(6, 6) = O;
+    ASSERT_TRUE(is_five_at(cells, {4, 4}, X));
+
+    // a gap splits the run
+    cells(0, 3) = X;
+    cells(0, 4) = X;
+    cells(0, 6) = X;
+    cells(0, 7) = X;
+    ASSERT_FALSE(is_five_at(cells, {0, 2}, X));
+    ASSERT_TRUE(is_five_at(cells, {0, 5}, X));
 }
 
 TEST(State, is_terminal) {
@@ -260,6 +270,8 @@ TEST(State, is_terminal) {
     ASSERT_FALSE(state.is_terminal());
     state.move({4, 0}); // AI
     ASSERT_TRUE(state.is_terminal());
+    ASSERT_EQ(state.hvalue(), -win_at(9));
+    ASSERT_TRUE(is_loss(state.hvalue()));
     state.unmove(); // HUMAN
     ASSERT_FALSE(state.is_terminal());
     state.move({3, -1}); // AI
@@ -267,9 +279,219 @@ TEST(State, is_terminal) {
     ASSERT_FALSE(state.is_terminal());
     state.move({4, 1}); // HUMAN
     ASSERT_TRUE(state.is_terminal());
+    ASSERT_EQ(state.hvalue(), win_at(10));
+    ASSERT_TRUE(is_win(state.hvalue()));
     ASSERT_EQ(state.current_player(), Cell::HUMAN);
 }
 
+static Score brute_force_gain(const State& state, Action action, Cell player) {
+    const Action directions[4] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+    Score result = 0;
+    for (auto direction: directions) {
+        Line line;
+        for (int d = -threat_radius; d <= threat_radius; d++) {
+            int x = action.x + d * direction.x;
+            int y = action.y + d * direction.y;
+            line.push_back(state(x, y));
+        }
+        auto before = score_of_line(line, player);
+        line[threat_radius] = player;
+        auto after = score_of_line(line, player);
+        if (before != win_score)
+            result += after == win_score ? win_score : after - before;
+    }
+    return std::min(result, win_score);
+}
+
+TEST(State, gain) {
+    State state;
+    Action moves[] = {{0, 0}, {1, 1}, {1, 0}, {2, 0}, {0, 1}, {-1, -1}, {0, -1}};
+    for (auto action: moves) {
+        state.move(action);
+        for (auto legal: state.legal_actions()) {
+            ASSERT_EQ(state.gain(legal, X), brute_force_gain(state, legal, X));
+            ASSERT_EQ(state.gain(legal, O), brute_force_gain(state, legal, O));
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        state.unmove();
+        for (auto legal: state.legal_actions()) {
+            ASSERT_EQ(state.gain(legal, X), brute_force_gain(state, legal, X));
+            ASSERT_EQ(state.gain(legal, O), brute_force_gain(state, legal, O));
+        }
+    }
+}
+
+// the forcing actions scanned with wins()
+static std::vector<Action> brute_force_forcing_actions(const State& state) {
+    std::vector<Action> winning, blocking;
+    auto player = state.current_player();
+    for (auto action: state.legal_actions()) {
+        if (state.wins(action, player))
+            winning.push_back(action);
+        else if (state.wins(action, inverse_of(player)))
+            blocking.push_back(action);
+    }
+    return winning.empty() ? blocking : winning;
+}
+
+static void assert_same_actions(std::vector<Action> value, std::vector<Action> expected) {
+    auto less = [](Action a, Action b) { return a.x < b.x || (a.x == b.x && a.y < b.y); };
+    std::sort(value.begin(), value.end(), less);
+    std::sort(expected.begin(), expected.end(), less);
+    ASSERT_EQ(value, expected);
+}
+
+TEST(State, forcing_actions_of_threat_map) {
+    State state{Cell::AI};
+    Action moves[] = {{0, 0}, {0, 1}, {1, 0}, {1, 1}, {2, 0}, {2, 1}, {3, 0}, {-1, 0},
+        {2, 2}, {4, 0}, {1, -1}, {3, 1}, {-1, 1}, {4, 2}};
+    for (auto action: moves) {
+        state.move(action);
+        ASSERT_FALSE(state.is_terminal());
+        assert_same_actions(state.forcing_actions(), brute_force_forcing_actions(state));
+    }
+    for (int i = 0; i < 6; i++) {
+        state.unmove();
+        assert_same_actions(state.forcing_actions(), brute_force_forcing_actions(state));
+    }
+}
+
+TEST(State, forcing_actions) {
+    State state{Cell::AI};
+    state.move({0, 0}); // AI
+    state.move({0, 1}); // HUMAN
+    state.move({1, 0});
+    state.move({1, 1});
+    state.move({2, 0});
+    state.move({2, 1});
+    ASSERT_TRUE(state.forcing_actions().empty());
+
+    state.move({3, 0});
+    ASSERT_EQ(state.gain({4, 0}, X), win_score);
+
+    // HUMAN has to block the open four
+    auto actions = state.forcing_actions();
+    ASSERT_EQ(actions.size(), 2);
+    assert_contains(actions, {-1, 0});
+    assert_contains(actions, {4, 0});
+
+    state.move({3, 1});
+    actions = state.forcing_actions();
+    ASSERT_EQ(actions.size(), 2);
+    assert_contains(actions, {-1, 0});
+    assert_contains(actions, {4, 0});
+
+    // both fours can be completed or blocked at either end
+    auto ordered = state.ordered_actions(4);
+    ASSERT_EQ(ordered.size(), 4);
+    assert_contains(ordered, {-1, 0});
+    assert_contains(ordered, {4, 0});
+    assert_contains(ordered, {-1, 1});
+    assert_contains(ordered, {4, 1});
+}
+
+static void assert_state_eq(const State& value, const State& compared) {
+    ASSERT_EQ(value.current_player(), compared.current_player());
+    ASSERT_EQ(value.is_terminal(), compared.is_terminal());
+    ASSERT_EQ(value.hvalue(), compared.hvalue());
+    ASSERT_EQ(value.moves(), compared.moves());
+
+    auto actions = value.legal_actions();
+    ASSERT_EQ(actions, compared.legal_actions());
+    for (auto action: actions) {
+        ASSERT_EQ(value.gain(action, X), compared.gain(action, X));
+        ASSERT_EQ(value.gain(action, O), compared.gain(action, O));
+    }
+}
+
+// a column of stones reaches far from the first ones, every move legal
+static State played_state() {
+    auto state = played(Cell::AI, {{0, 0}, {1, 1}, {1, 0}, {2, 0}, {0, 1}, {-1, -1}});
+    for (int y = -2; y >= -10; y -= 2) {
+        EXPECT_TRUE(state.is_legal({3, y}));
+        state.move({3, y});
+    }
+    return state;
+}
+
+TEST(State, snapshot) {
+    auto state = played(Cell::AI, {{0, 0}, {1, 1}, {1, 0}, {2, 0}, {0, 1}, {-1, -1}, {3, -2}});
+    auto snapshot = state.snapshot();
+    ASSERT_EQ(snapshot.start_player, Cell::AI);
+    ASSERT_EQ(snapshot.moves.size(), 7);
+
+    State rebuilt{snapshot};
+    assert_state_eq(rebuilt, state);
+
+    auto data = serialize(snapshot);
+    ASSERT_EQ(data.size(), 1 + 6 * 2 + 2);
+    State deserialized{deserialize(data)};
+    assert_state_eq(deserialized, state);
+
+    ASSERT_THROW(deserialize(""), std::invalid_argument);
+    ASSERT_THROW(deserialize(data.substr(0, data.size() - 1)), std::invalid_argument);
+
+    // 2^32 doesn't fit the 32 bits of a coordinate
+    auto overflow = serialize(Snapshot{Cell::AI, {}}) + std::string{"\x80\x80\x80\x80\x10\x00", 6};
+    ASSERT_THROW(deserialize(overflow), std::invalid_argument);
+    Snapshot extreme{Cell::AI, {{INT_MIN, INT_MAX}}};
+    ASSERT_EQ(deserialize(serialize(extreme)).moves[0], extreme.moves[0]);
+}
+
+TEST(State, invalid_snapshot) {
+    Snapshot duplicate{Cell::AI, {{0, 0}, {1, 1}, {0, 0}}};
+    ASSERT_THROW(State{duplicate}, std::invalid_argument);
+
+    Snapshot far{Cell::AI, {{0, 0}, {30, -40}}};
+    ASSERT_THROW(State{far}, std::invalid_argument);
+
+    Snapshot after_five{Cell::AI, {}};
+    for (int x = 0; x < 5; x++) {
+        after_five.moves.push_back({x, 0});
+        after_five.moves.push_back({x, 2});
+    }
+    ASSERT_THROW(State{after_five}, std::invalid_argument);
+    after_five.moves.pop_back();
+    ASSERT_TRUE(State{after_five}.is_terminal());
+}
+
+TEST(State, clone) {
+    auto state = played_state();
+    assert_state_eq(State{state.snapshot()}, state);
+    auto clone = state.clone();
+    assert_state_eq(clone, state);
+
+    clone.move({3, 0});
+    state.move({3, 0});
+    assert_state_eq(clone, state);
+
+    for (int i = 0; i < 4; i++) {
+        clone.unmove();
+        state.unmove();
+        assert_state_eq(clone, state);
+    }
+}
+
+TEST(State, AI_next_move_reports) {
+    auto state = played_state();
+    if (state.current_player() != Cell::AI)
+        state.move({3, 0});
+    std::vector<SearchReport> reports;
+    SearchControl control;
+    control.report = [&reports](const SearchReport& report) { reports.push_back(report); };
+    AI_next_move(state, control);
+
+    ASSERT_FALSE(reports.empty());
+    for (size_t i = 1; i < reports.size(); i++) {
+        ASSERT_EQ(reports[i].depth, reports[i - 1].depth + 1);
+        ASSERT_GT(reports[i].nodes, reports[i - 1].nodes);
+        ASSERT_GE(reports[i].elapsed, reports[i - 1].elapsed);
+    }
+    ASSERT_GT(reports.back().nodes, 0);
+}
+
 TEST(State, maximizing) {
     State state(Cell::AI);
     ASSERT_TRUE(state.is_maximizing());
@@ -277,6 +499,20 @@ TEST(State, maximizing) {
     ASSERT_FALSE(state.is_maximizing());
 }
 
+TEST(State, generic_minimax) {
+    using Traits = GameTraits<State>;
+    static_assert(std::is_same<Traits::Action, Action>::value, "");
+    static_assert(std::is_same<Traits::Value, Score>::value, "");
+    static_assert(has_state_hash<State>::value, "");
+
+    auto state = played_state();
+    for (unsigned int depth = 1; depth <= 3; depth++) {
+        Minimax<State> solver{state, int(depth)};
+        solver.next_action();
+        ASSERT_EQ(solver.value(), alphabeta(state, depth, -win_score, win_score));
+    }
+}
+
 } // namespace gomoku
 } // namespace game
 } // namespace ai
@@ -0,0 +1,116 @@
+#include <gmock/gmock.h>
+#include <ai/game/mnk/State.hpp>
+#include <ai/game/Minimax.hpp>
+#include <limits>
+
+namespace ai {
+namespace game {
+namespace mnk {
+
+using Board = State<4, 4, 3>;
+
+const auto N = Board::NONE;
+const auto X = Board::X;
+const auto O = Board::O;
+
+TEST(MNK, legalActions) {
+    Board state{
+        {X, N, N, O,
+         N, N, N, N,
+         N, N, X, N,
+         N, N, N, O}, Board::PLAYER_AI};
+    auto actions = state.legalActions();
+    ASSERT_EQ(actions.size(), 12);
+    ASSERT_EQ(actions[0].x(), 2);
+    ASSERT_EQ(actions[0].y(), 1);
+    ASSERT_EQ(actions[11].x(), 3);
+    ASSERT_EQ(actions[11].y(), 4);
+}
+
+TEST(MNK, lines_do_not_wrap) {
+    Board::Player win_player;
+    float utility;
+
+    // the end of a row followed by the start of the next one
+    Board row{
+        {N, N, X, X,
+         X, N, N, N}, Board::PLAYER_AI};
+    ASSERT_FALSE(row.is_terminal(win_player, utility));
+
+    Board diagonal{
+        {N, N, N, X,
+         X, N, N, N,
+         N, X, N, N}, Board::PLAYER_AI};
+    ASSERT_FALSE(diagonal.is_terminal(win_player, utility));
+
+    Board second_diagonal{
+        {N, X, N, N,
+         X, N, N, N,
+         N, N, N, X}, Board::PLAYER_AI};
+    ASSERT_FALSE(second_diagonal.is_terminal(win_player, utility));
+}
+
+TEST(MNK, move_wins) {
+    Board::Player win_player;
+    float utility;
+
+    Board state{Board::PLAYER_PERSON};
+    state.move(Action(4, 2));
+    state.move(Action(1, 1));
+    state.move(Action(3, 3));
+    state.move(Action(1, 2));
+    ASSERT_FALSE(state.is_terminal(win_player, utility));
+    state.move(Action(2, 4));
+    ASSERT_TRUE(state.is_terminal(win_player, utility));
+    ASSERT_EQ(win_player, Board::PLAYER_PERSON);
+    ASSERT_EQ(utility, -std::numeric_limits<float>::infinity());
+
+    state.unmove(Action(2, 4));
+    ASSERT_FALSE(state.is_terminal(win_player, utility));
+    state.move(Action(4, 4));
+    state.move(Action(1, 3));
+    ASSERT_TRUE(state.is_terminal(win_player, utility));
+    ASSERT_EQ(win_player, Board::PLAYER_AI);
+}
+
+TEST(MNK, minimax) {
+    // the first player wins 4,3,3 and 4,4,3, 4,4,4 is a draw
+    {
+        State<4, 3, 3> state{State<4, 3, 3>::PLAYER_AI};
+        Minimax<State<4, 3, 3>> solver{state};
+        solver.next_action();
+        ASSERT_EQ(solver.value(), std::numeric_limits<float>::infinity());
+    }
+    {
+        Board state{Board::PLAYER_PERSON};
+        Minimax<Board> solver{state};
+        solver.next_action();
+        ASSERT_EQ(solver.value(), -std::numeric_limits<float>::infinity());
+    }
+    {
+        State<4, 4, 4> state{State<4, 4, 4>::PLAYER_AI};
+        Minimax<State<4, 4, 4>> solver{state};
+        solver.next_action();
+        ASSERT_EQ(solver.value(), 0.0f);
+    }
+}
+
+TEST(MNK, large_board) {
+    using Large = State<7, 7, 5>;
+    static_assert(has_state_hash<Large>::value, "");
+
+    Large state{Large::PLAYER_AI};
+    for (int x = 1; x <= 4; x++) {
+        state.move(Action(x, 7));
+        state.move(Action(x, 1));
+    }
+    Minimax<Large> solver{state, 2};
+    auto next = solver.next_action();
+    ASSERT_EQ(next.x(), 5);
+    ASSERT_EQ(next.y(), 7);
+    ASSERT_EQ(solver.value(), std::numeric_limits<float>::infinity());
+}
+
+} // namespace mnk
+} // namespace game
+} // namespace ai
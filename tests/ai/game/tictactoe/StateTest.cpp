@@ -1,5 +1,7 @@
 #include <gmock/gmock.h>
 #include <ai/game/tictactoe/State.hpp>
+#include <vector>
+#include <algorithm>
 
 namespace ai {
 namespace game {
@@ -145,6 +147,45 @@ TEST(State, is_terminal) {
     ASSERT_EQ(utility, 0.0f);
 }
 
+TEST(State, every_line_wins) {
+    const int lines[8][3] = {
+        {0, 1, 2}, {3, 4, 5}, {6, 7, 8},
+        {0, 3, 6}, {1, 4, 7}, {2, 5, 8},
+        {0, 4, 8}, {2, 4, 6}
+    };
+    State::Player win_player;
+    float utility;
+
+    for (auto& line: lines) {
+        std::vector<int> others;
+        for (int index = 0; index < 9; index++)
+            if (std::find(line, line + 3, index) == line + 3)
+                others.push_back(index);
+
+        State state{State::PLAYER_PERSON};
+        for (int i = 0; i < 3; i++) {
+            ASSERT_FALSE(state.is_terminal(win_player, utility));
+            state.move(Action(line[i] % 3 + 1, line[i] / 3 + 1));
+            if (i < 2)
+                state.move(Action(others[i] % 3 + 1, others[i] / 3 + 1));
+        }
+        ASSERT_TRUE(state.is_terminal(win_player, utility));
+        ASSERT_EQ(win_player, State::PLAYER_PERSON);
+    }
+}
+
+TEST(State, legalActions_after_unmove) {
+    State state{State::PLAYER_AI};
+    state.move(Action(2, 2));
+    state.move(Action(1, 3));
+    ASSERT_EQ(state.legalActions().size(), 7);
+    state.unmove(Action(1, 3));
+    auto actions = state.legalActions();
+    ASSERT_EQ(actions.size(), 8);
+    assert_action_equals(actions[4], 3, 2);
+    assert_action_equals(actions[5], 1, 3);
+}
+
 } // namespace tictactoe
 } // namespace game
 } // namespace ai